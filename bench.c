@@ -0,0 +1,613 @@
+#include "source/include.h"
+
+#ifdef __GLIBC__
+    #include <malloc.h>
+#endif
+
+/* ================================================================ */
+
+/**
+ * Microbenchmarks of the world: evolution across sizes, densities, edge types, layouts and engines,
+ * saving and loading, randomizing, and drawing into an offscreen window with every renderer.
+ * Every case starts from a soup seeded with `--seed`, so two runs of the same build evolve the same cells.
+ * Results go to the standard output, a line per case, as CSV or, with `--json`, as a JSON array:
+ * the time per cell, the iterations (generations, saves, frames...) per second, and the heap the case holds at its end.
+ *
+ * Like the game, it reads `world.json` from the working directory first, and creates it if it is missing.
+ *
+ * make bench && ./bench.out [--seed N] [--threads N] [--json] [--quick]
+*/
+
+/* ================================================================ */
+
+#define SEED 1                  /* Default seed of the soups */
+
+#define WORK (1 << 27)          /* Cells an evolution case goes through, so every size takes about as long */
+#define IO (1 << 25)            /* Cells a save, load or randomize case goes through */
+#define FRAMES (1 << 24)        /* Cells a render case draws */
+
+#define PIXELS 1024             /* Largest side of an offscreen window */
+
+#define SCRATCH "/tmp/gol-bench-XXXXXX"     /* Directory of the files written by the cases */
+
+static const size_t SIDES[] = {256, 1024, 4096};
+
+static const double DENSITIES[] = {0.05, 0.25, 0.5};
+
+static const char* EDGES[] = {"", "torus", "dead", "alive"};
+
+static const char* STORAGES[] = {"", "bits", "bytes"};
+
+static const char* ENGINES[] = {"", "grid", "hashlife", "sparse"};
+
+static const char* RENDERER[RENDERERS] = {"texture", "rects", "cells"};
+
+/* ================================================================ */
+
+/**
+ * A single case: the world it runs on.
+*/
+struct bench {
+
+    const char* name;
+
+    size_t side;                /* Number of rows and columns */
+    double density;             /* Share of cells the soup tries to set */
+
+    int type;                   /* Edge type */
+    int storage;
+    int engine;
+    int renderer;
+
+    size_t cell_size;           /* Size of a cell in the offscreen window */
+};
+
+typedef struct bench Bench;
+
+/* ================================ */
+
+/**
+ * What a case measured.
+*/
+struct result {
+
+    size_t iterations;          /* Generations, saves, loads, randomizations or frames */
+    double seconds;
+
+    long long bytes;            /* Heap the case holds at its end, world included */
+};
+
+typedef struct result Result;
+
+/* ================================================================ */
+
+static unsigned seed = SEED;
+
+static int threads = 1;
+
+static int is_json = 0;
+
+static int is_quick = 0;
+
+static char scratch[] = SCRATCH;
+
+static size_t reported = 0;     /* Number of results printed so far */
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+static double _Bench_now(void) {
+
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* ================================ */
+
+/**
+ * Get the number of bytes allocated on the heap, or 0 where the C library does not tell.
+*/
+static long long _Bench_heap(void) {
+
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+
+    struct mallinfo2 info = mallinfo2();
+
+    /* Small blocks live in the arenas, large ones (grids) are mapped on their own */
+    return (long long) (info.uordblks + info.hblkhd);
+
+#else
+
+    return 0;
+
+#endif
+}
+
+/* ================================ */
+
+/**
+ * Print the result of a case, as a CSV line or a JSON object.
+*/
+static void _Bench_report(const Bench* b, const Result* r) {
+
+    double cells = (double) r->iterations * b->side * b->side;
+
+    double ns = (cells > 0) ? 1e9 * r->seconds / cells : 0;
+    double rate = (r->seconds > 0) ? r->iterations / r->seconds : 0;
+
+    if (is_json) {
+
+        printf("%s\n  {\"benchmark\": \"%s\", \"rows\": %zu, \"columns\": %zu, \"density\": %g, \"edge\": \"%s\", \"storage\": \"%s\", \"engine\": \"%s\", \"renderer\": \"%s\", "
+            "\"seed\": %u, \"threads\": %d, \"iterations\": %zu, \"seconds\": %.6f, \"ns_per_cell\": %.4f, \"per_second\": %.2f, \"bytes\": %lld}",
+            (reported > 0) ? "," : "[", b->name, b->side, b->side, b->density, EDGES[b->type], STORAGES[b->storage], ENGINES[b->engine], RENDERER[b->renderer],
+            seed, threads, r->iterations, r->seconds, ns, rate, r->bytes);
+    }
+    else {
+
+        if (reported == 0) {
+            printf("benchmark,rows,columns,density,edge,storage,engine,renderer,seed,threads,iterations,seconds,ns_per_cell,per_second,bytes\n");
+        }
+
+        printf("%s,%zu,%zu,%g,%s,%s,%s,%s,%u,%d,%zu,%.6f,%.4f,%.2f,%lld\n",
+            b->name, b->side, b->side, b->density, EDGES[b->type], STORAGES[b->storage], ENGINES[b->engine], RENDERER[b->renderer],
+            seed, threads, r->iterations, r->seconds, ns, rate, r->bytes);
+    }
+
+    fflush(stdout);
+
+    reported++;
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Build the path of the file `name` in the scratch directory.
+*/
+static void _Bench_path(char* path, size_t size, const char* name) {
+
+    snprintf(path, size, "%s/%s", scratch, name);
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Create the world of a case through a settings file, as a saved world would be, and fill it with its soup.
+*/
+static World_t _Bench_world(const Bench* b) {
+
+    World_t w = NULL;
+
+    cJSON* root = NULL;
+
+    FILE* file = NULL;
+
+    char path[256];
+
+    char* text = NULL;
+
+    if ((root = cJSON_CreateObject()) == NULL) {
+        return NULL;
+    }
+
+    cJSON_AddNumberToObject(root, "cell_size", (double) b->cell_size);
+    cJSON_AddNumberToObject(root, "width", (double) (b->side * b->cell_size));
+    cJSON_AddNumberToObject(root, "height", (double) (b->side * b->cell_size));
+    cJSON_AddStringToObject(root, "storage", STORAGES[b->storage]);
+    cJSON_AddNumberToObject(root, "percent", 0);
+    cJSON_AddNumberToObject(root, "is_grid", 0);
+    cJSON_AddNumberToObject(root, "threads", threads);
+    cJSON_AddStringToObject(root, "engine", ENGINES[b->engine]);
+    cJSON_AddStringToObject(root, "renderer", RENDERER[b->renderer]);
+    cJSON_AddStringToObject(root, "rule", RULE_LIFE);
+    cJSON_AddNumberToObject(root, "type", b->type);
+
+    _Bench_path(path, sizeof(path), "case.json");
+
+    if (((text = cJSON_Print(root)) == NULL) || ((file = fopen(path, "w")) == NULL)) {
+
+        free(text);
+        cJSON_Delete(root);
+
+        return NULL;
+    }
+
+    fputs(text, file);
+    fclose(file);
+
+    free(text);
+    cJSON_Delete(root);
+
+    if ((w = World_new()) == NULL) {
+        return NULL;
+    }
+
+    if ((World_load(path, w) == EXIT_FAILURE) || (w->rows != b->side) || (w->columns != b->side)) {
+
+        World_destroy(&w);
+
+        return NULL;
+    }
+
+    remove(path);
+
+    /* The soup only depends on the seed */
+    Grid_clear(World_current(w), 0);
+    Grid_clear(World_previous(w), 0);
+
+    w->generation = 0;
+
+    srand(seed);
+
+    World_randomize(w, (int) (b->density * b->side * b->side));
+
+    return w;
+}
+
+/* ================================ */
+
+static int _Bench_evolve(const Bench* b, Result* r) {
+
+    World_t w = NULL;
+
+    size_t generations = (WORK / (b->side * b->side) > 8) ? WORK / (b->side * b->side) : 8;
+    size_t previous = 0;
+
+    double start = 0;
+
+    if ((w = _Bench_world(b)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    start = _Bench_now();
+
+    /* A HashLife step may go past the last generation */
+    while (w->generation < generations) {
+
+        previous = w->generation;
+
+        World_evolve(w);
+
+        /* The engine ran out of memory */
+        if (w->generation == previous) {
+            break ;
+        }
+    }
+
+    r->seconds = _Bench_now() - start;
+    r->iterations = w->generation;
+    r->bytes = _Bench_heap();
+
+    World_destroy(&w);
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Save the world (`b->name` "save") or load it (`b->name` "load") as many times as it takes to go through `IO` cells.
+*/
+static int _Bench_io(const Bench* b, Result* r) {
+
+    World_t w = NULL;
+
+    char path[256];
+    char snapshot[256];
+
+    size_t times = (IO / (b->side * b->side) > 3) ? IO / (b->side * b->side) : 3;
+    size_t i = 0;
+
+    double start = 0;
+
+    int status = EXIT_SUCCESS;
+
+    if ((w = _Bench_world(b)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    _Bench_path(path, sizeof(path), "world.json");
+    _Bench_path(snapshot, sizeof(snapshot), "world.gol");
+
+    /* Loads read what a save wrote */
+    if (World_save(path, w) == EXIT_FAILURE) {
+
+        World_destroy(&w);
+
+        return EXIT_FAILURE;
+    }
+
+    start = _Bench_now();
+
+    for (i = 0; (i < times) && (status == EXIT_SUCCESS); i++) {
+        status = (strcmp(b->name, "save") == 0) ? World_save(path, w) : World_load(path, w);
+    }
+
+    r->seconds = _Bench_now() - start;
+    r->iterations = i;
+    r->bytes = _Bench_heap();
+
+    World_destroy(&w);
+
+    remove(path);
+    remove(snapshot);
+
+    return status;
+}
+
+/* ================================ */
+
+static int _Bench_randomize(const Bench* b, Result* r) {
+
+    World_t w = NULL;
+
+    size_t times = (IO / (b->side * b->side) > 3) ? IO / (b->side * b->side) : 3;
+    size_t i = 0;
+
+    double start = 0;
+
+    if ((w = _Bench_world(b)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    start = _Bench_now();
+
+    for (i = 0; i < times; i++) {
+        World_randomize(w, (int) (b->density * b->side * b->side));
+    }
+
+    r->seconds = _Bench_now() - start;
+    r->iterations = times;
+    r->bytes = _Bench_heap();
+
+    World_destroy(&w);
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Draw frames into a hidden window through the software renderer, evolving the world between them.
+ * Only the drawing is timed.
+*/
+static int _Bench_render(const Bench* b, Result* r) {
+
+    World_t w = NULL;
+
+    Window_t window = NULL;
+
+    size_t frames = (FRAMES / (b->side * b->side) > 16) ? FRAMES / (b->side * b->side) : 16;
+    size_t i = 0;
+
+    double start = 0;
+
+    if ((w = _Bench_world(b)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    if ((window = Window_new("bench", (int) (b->side * b->cell_size), (int) (b->side * b->cell_size), SDL_WINDOW_HIDDEN, SDL_RENDERER_SOFTWARE)) == NULL) {
+
+        World_destroy(&w);
+
+        return EXIT_FAILURE;
+    }
+
+    SDL_SetRenderDrawBlendMode(window->renderer, SDL_BLENDMODE_BLEND);
+
+    for (i = 0; i < frames; i++) {
+
+        World_evolve(w);
+
+        start = _Bench_now();
+
+        SDL_SetRenderDrawColor(window->renderer, w->bg_color[0], w->bg_color[1], w->bg_color[2], w->bg_color[3]);
+        SDL_RenderClear(window->renderer);
+
+        SDL_SetRenderDrawColor(window->renderer, w->c_color[0], w->c_color[1], w->c_color[2], w->c_color[3]);
+        World_present(w, window);
+
+        /* Drawing calls are batched until the frame is presented */
+        SDL_RenderPresent(window->renderer);
+
+        r->seconds += _Bench_now() - start;
+    }
+
+    r->iterations = frames;
+    r->bytes = _Bench_heap();
+
+    /* A renderer that failed hands over to the next one; the case only measures its own */
+    if (w->renderer != b->renderer) {
+        r->iterations = 0;
+    }
+
+    /* Textures go before their renderer */
+    View_destroy(&w->view);
+    Overlay_destroy(&w->overlay);
+
+    Window_destroy(&window);
+
+    World_destroy(&w);
+
+    return (r->iterations > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ================================ */
+
+/**
+ * Run a case and print its result, or a line on the standard error if it cannot run.
+*/
+static void _Bench_run(const Bench* b, int (*run)(const Bench*, Result*)) {
+
+    Result r = {0};
+
+    long long before = _Bench_heap();
+
+    if (run(b, &r) == EXIT_FAILURE) {
+
+        fprintf(stderr, "%s %zux%zu %s %s %s %s: failed\n", b->name, b->side, b->side, EDGES[b->type], STORAGES[b->storage], ENGINES[b->engine], RENDERER[b->renderer]);
+
+        return ;
+    }
+
+    r.bytes -= before;
+
+    _Bench_report(b, &r);
+
+    return ;
+}
+
+/* ================================================================ */
+
+int main(int argc, char** argv) {
+
+    Bench b = {.type = GRID_TORUS, .storage = GRID_BITS, .engine = ENGINE_GRID, .renderer = RENDER_TEXTURE, .cell_size = 1};
+
+    size_t sides = sizeof(SIDES) / sizeof(SIDES[0]);
+
+    size_t s = 0;
+    size_t d = 0;
+
+    int option = 0;
+
+    int video = 0;
+
+    static struct option long_options[] = {
+        {"seed", required_argument, NULL, 0},
+        {"threads", required_argument, NULL, 1},
+        {"json", no_argument, NULL, 2},
+        {"quick", no_argument, NULL, 3},
+        {NULL, 0, NULL, 0},
+    };
+
+    while ((option = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+
+        switch (option) {
+
+            case 0:
+                seed = (unsigned) strtoul(optarg, NULL, 10);
+
+                break ;
+
+            case 1:
+                threads = atoi(optarg);
+
+                break ;
+
+            case 2:
+                is_json = 1;
+
+                break ;
+
+            case 3:
+                is_quick = 1;
+
+                break ;
+
+            default:
+                fprintf(stderr, "usage: %s [--seed N] [--threads N] [--json] [--quick]\n", argv[0]);
+
+                return EXIT_FAILURE;
+        }
+    }
+
+    /* Only the smallest size */
+    if (is_quick) {
+        sides = 1;
+    }
+
+    if (mkdtemp(scratch) == NULL) {
+
+        fprintf(stderr, "Cannot create %s\n", scratch);
+
+        return EXIT_FAILURE;
+    }
+
+    /* Windows are drawn into memory, even with a display */
+    setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+    video = (SDL_Init(SDL_INIT_VIDEO) == 0);
+
+    for (s = 0; s < sides; s++) {
+
+        b.side = SIDES[s];
+
+        for (d = 0; d < sizeof(DENSITIES) / sizeof(DENSITIES[0]); d++) {
+
+            b.density = DENSITIES[d];
+            b.cell_size = 1;
+            b.renderer = RENDER_TEXTURE;
+
+            /* ============================ Evolve ============================ */
+            b.name = "evolve";
+            b.engine = ENGINE_GRID;
+
+            for (b.storage = GRID_BITS; b.storage <= GRID_BYTES; b.storage++) {
+
+                for (b.type = GRID_TORUS; b.type <= GRID_ALIVE; b.type++) {
+                    _Bench_run(&b, _Bench_evolve);
+                }
+            }
+
+            /* Planes have no edges */
+            b.type = GRID_TORUS;
+            b.storage = GRID_BITS;
+
+            for (b.engine = ENGINE_HASHLIFE; b.engine <= ENGINE_SPARSE; b.engine++) {
+                _Bench_run(&b, _Bench_evolve);
+            }
+
+            b.engine = ENGINE_GRID;
+
+            /* ========================== Save, load ========================== */
+            for (b.storage = GRID_BITS; b.storage <= GRID_BYTES; b.storage++) {
+
+                b.name = "save";
+                _Bench_run(&b, _Bench_io);
+
+                b.name = "load";
+                _Bench_run(&b, _Bench_io);
+            }
+
+            b.storage = GRID_BITS;
+
+            /* =========================== Randomize ========================== */
+            b.name = "randomize";
+            _Bench_run(&b, _Bench_randomize);
+
+            /* ============================ Render ============================ */
+            if (!video || (b.side > PIXELS)) {
+                continue ;
+            }
+
+            b.name = "render";
+            b.cell_size = PIXELS / b.side;
+
+            for (b.renderer = RENDER_TEXTURE; b.renderer < RENDERERS; b.renderer++) {
+                _Bench_run(&b, _Bench_render);
+            }
+        }
+    }
+
+    if (is_json) {
+        printf((reported > 0) ? "\n]\n" : "[]\n");
+    }
+
+    if (!video) {
+        fprintf(stderr, "Cannot initialize SDL, render cases skipped: %s\n", SDL_GetError());
+    }
+    else {
+        SDL_Quit();
+    }
+
+    rmdir(scratch);
+
+    return EXIT_SUCCESS;
+}
@@ -16,6 +16,35 @@ static int is_edit = 0;
 
 static int is_clean = 0;
 
+static int threads = -1;                                /* Number of evolution threads. -1 - as set in `world.json` */
+
+static int is_headless = 0;                             /* Evolve without a window, as fast as possible */
+
+static size_t generations = 0;                          /* Number of generations evolved by a headless run */
+
+static int is_verify = 0;                               /* Check every implementation against the reference kernel and exit */
+
+static const char* record_file = NULL;                  /* Log to record the generations into */
+
+static size_t record_every = 1;                         /* Record every n-th generation */
+
+static const char* replay_file = NULL;                  /* Log to take the starting generation from */
+
+static size_t seek = 0;                                 /* Generation to take from the log */
+
+static size_t autosave_every = 0;                       /* Save the world every n generations, or seconds with an `s` suffix. 0 - never */
+
+static int autosave_seconds = 0;
+
+#define AUTOSAVE_FILE "autosave.json"                   /* Autosave target unless a save file is given */
+
+static const char* import_file = NULL;                  /* Pattern to add to the world */
+
+static int64_t import_row = 0;                          /* Where the top left corner of the pattern goes */
+static int64_t import_column = 0;
+
+static const char* export_file = NULL;                  /* Pattern file the last generation is written into */
+
 /* ================================================================ */
 
 int main(int argc, char** argv) {
@@ -43,6 +72,18 @@ int main(int argc, char** argv) {
             {"load", required_argument, NULL, 1},
             {"edit", no_argument, NULL, 2},
             {"clean", no_argument, NULL, 3},
+            {"threads", required_argument, NULL, 5},
+            {"headless", no_argument, NULL, 6},
+            {"generations", required_argument, NULL, 7},
+            {"record", required_argument, NULL, 8},
+            {"record-every", required_argument, NULL, 9},
+            {"replay", required_argument, NULL, 10},
+            {"seek", required_argument, NULL, 11},
+            {"autosave-every", required_argument, NULL, 12},
+            {"import", required_argument, NULL, 13},
+            {"at", required_argument, NULL, 14},
+            {"export", required_argument, NULL, 15},
+            {"verify", no_argument, NULL, 16},
             {NULL, 0, NULL, 4},
         };
 
@@ -102,6 +143,89 @@ int main(int argc, char** argv) {
 
                 break ;
 
+            case 5:
+
+                if (optarg) {
+                    threads = atoi(optarg);
+                }
+
+                break ;
+
+            case 6:
+                is_headless = !is_headless;
+
+                break ;
+
+            case 7:
+
+                if (optarg) {
+                    generations = strtoull(optarg, NULL, 10);
+                }
+
+                break ;
+
+            case 8:
+                record_file = optarg;
+
+                break ;
+
+            case 9:
+
+                if (optarg) {
+                    record_every = strtoull(optarg, NULL, 10);
+                }
+
+                break ;
+
+            case 10:
+                replay_file = optarg;
+
+                break ;
+
+            case 11:
+
+                if (optarg) {
+                    seek = strtoull(optarg, NULL, 10);
+                }
+
+                break ;
+
+            case 12:
+
+                if (optarg) {
+
+                    autosave_every = strtoull(optarg, &sub, 10);
+                    autosave_seconds = (*sub == 's');
+                }
+
+                break ;
+
+            case 13:
+                import_file = optarg;
+
+                break ;
+
+            case 14:
+
+                /* ROW,COLUMN */
+                if (optarg) {
+
+                    import_row = strtoll(optarg, &sub, 10);
+                    import_column = (*sub == ',') ? strtoll(sub + 1, NULL, 10) : 0;
+                }
+
+                break ;
+
+            case 15:
+                export_file = optarg;
+
+                break ;
+
+            case 16:
+                is_verify = !is_verify;
+
+                break ;
+
             case 4:
 
             case ':':
@@ -119,7 +243,13 @@ int main(int argc, char** argv) {
 
     /* ================================================================ */
 
-    if ((LilEn_init("settings.json")) == EXIT_FAILURE) {
+    /* Verification needs neither SDL nor a world */
+    if (is_verify) {
+        exit(Verify_run((generations > 0) ? generations : VERIFY_GENERATIONS, (threads >= 0) ? (size_t) threads : 0));
+    }
+
+    /* A headless run never touches SDL */
+    if (!is_headless && ((LilEn_init("settings.json")) == EXIT_FAILURE)) {
 
         LilEn_print_error();
 
@@ -129,29 +259,79 @@ int main(int argc, char** argv) {
     if ((world = World_new()) == NULL) {
         LilEn_print_error();
 
-        LilEn_quit();
+        if (!is_headless) {
+            LilEn_quit();
+        }
 
         exit(EXIT_FAILURE);
     }
 
-    if ((window = Window_new("Game of Life", world->width, world->height, SDL_WINDOW_SHOWN, SDL_RENDERER_ACCELERATED)) == NULL) {
+    if (threads >= 0) {
+        world->threads = threads;
+    }
 
-        LilEn_print_error();
-        LilEn_quit();
+    if (!is_headless) {
 
-        exit(EXIT_FAILURE);
-    }
+        if ((window = Window_new("Game of Life", world->width, world->height, SDL_WINDOW_SHOWN, SDL_RENDERER_ACCELERATED)) == NULL) {
+
+            LilEn_print_error();
+            LilEn_quit();
+
+            exit(EXIT_FAILURE);
+        }
 
-    SDL_SetRenderDrawBlendMode(window->renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawBlendMode(window->renderer, SDL_BLENDMODE_BLEND);
+    }
 
     if (strlen(load_file) > 0) {
         World_load(location, world);
     }
 
-    if (is_edit) {
+    if ((import_file != NULL) && (World_import(world, import_file, import_row, import_column) == EXIT_FAILURE)) {
+        printf("Cannot import %s\n", import_file);
+    }
+
+    /* Start from the recorded generation closest to the one asked for */
+    if (replay_file != NULL) {
+
+        if (Record_seek(replay_file, seek, World_current(world), &world->generation) == EXIT_SUCCESS) {
+            Tiles_touch_all(world->tiles);
+        }
+        else {
+            printf("Cannot replay %s\n", replay_file);
+        }
+    }
+
+    if (record_file != NULL) {
+
+        if ((world->record = Record_new(record_file, world->rows, world->columns, record_every)) == NULL) {
+            printf("Cannot record into %s\n", record_file);
+        }
+
+        Record_push(world->record, World_current(world), world->generation);
+    }
+
+    /* Autosaves go where the final save does */
+    if (autosave_every > 0) {
+
+        char target[5 + BUFF] = "save/";
+
+        strcat(target, (strlen(save_file) > 0) ? save_file : AUTOSAVE_FILE);
+
+        if (World_autosave(world, target, autosave_every, autosave_seconds) == EXIT_FAILURE) {
+            printf("Cannot autosave into %s\n", target);
+        }
+    }
+
+    if (is_headless) {
+        World_run_headless(world, generations);
+    }
+    else if (is_edit) {
 
         if (is_clean) {
-            clear_2D_array(world->current, world->rows, world->columns, 0);
+            Grid_clear(World_current(world), 0);
+
+            Tiles_touch_all(world->tiles);
         }
 
         World_edit(world);
@@ -160,6 +340,10 @@ int main(int argc, char** argv) {
         World_run(world);
     }
 
+    if ((export_file != NULL) && (World_export(world, export_file) == EXIT_FAILURE)) {
+        printf("Cannot export %s\n", export_file);
+    }
+
     if (strlen(save_file) > 0) {
 
         /* Remove the old name */
@@ -169,13 +353,17 @@ int main(int argc, char** argv) {
         strcat(location, "save/");
         strcat(location, save_file);
         
-        /* Save the World! */
-        World_save(location, world);
+        /* Save the World! A failed save leaves the previous one in place */
+        if (World_save(location, world) == EXIT_FAILURE) {
+            printf("Cannot save %s\n", location);
+        }
     }
 
     World_log(world);
 
-    LilEn_quit();
+    if (!is_headless) {
+        LilEn_quit();
+    }
 
     World_destroy(&world);
 
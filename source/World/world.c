@@ -6,6 +6,15 @@
 /* Maximum filename size */
 #define MAX_FILENAME 32
 
+/* Maximum path size */
+#define MAX_PATH 256
+
+/* Extension of the snapshot saved next to a world file */
+#define SNAPSHOT_EXT ".gol"
+
+/* Names of the renderers in a world file */
+static const char* RENDERER[RENDERERS] = {"texture", "rects", "cells"};
+
 /* ================================================================ */
 /* ============================ STATIC ============================ */
 /* ================================================================ */
@@ -33,31 +42,655 @@ static World_t _World_alloc(void) {
 
 /* ================================ */
 
+/**
+ * Build the path of a file called `name` in the directory of the file `filename`.
+*/
+static void _World_sibling(char* path, const char* filename, const char* name) {
+
+    const char* slash = strrchr(filename, '/');
+
+    size_t size = (slash != NULL) ? (size_t) (slash - filename) + 1 : 0;
+
+    snprintf(path, MAX_PATH, "%.*s%s", (int) size, filename, name);
+
+    return ;
+}
+
+/* ================================ */
+
 #define CELL 4          /* Default cell size */
 #define WIDTH 400       /* Default width */
 #define HEIGHT 400      /* Defaul height */
 #define PERCENT .4      /* By default,40% of cells are being tried to initialized */
 
-/* Default world */
-static const struct world WORLD  = {
-    .cell_size = CELL,
-    .width = WIDTH,
-    .height = HEIGHT,
-    .is_grid = 1,
-    .g_color = {0, 0, 0, 25},
-    .c_color = {255, 0, 0, 255},
-    .bg_color = {255, 255, 255, 255},
-    .text_color = {0, 0, 0, 127},
-    .type = 1,
-    .rate = 10,
-    .percent = PERCENT,
-    .generation = 0,
-};
+/* Default world */
+static const struct world WORLD  = {
+    .cell_size = CELL,
+    .width = WIDTH,
+    .height = HEIGHT,
+    .is_grid = 1,
+    .g_color = {0, 0, 0, 25},
+    .c_color = {255, 0, 0, 255},
+    .bg_color = {255, 255, 255, 255},
+    .text_color = {0, 0, 0, 127},
+    .type = 1,
+    .rule = {.born = KERNEL_LIFE_BORN, .survives = KERNEL_LIFE_SURVIVES, .states = 2, .range = 1, .name = RULE_LIFE},
+    .storage = GRID_BITS,
+    .map = 0,
+    .rate = 10,
+    .threads = 1,
+    .engine = ENGINE_GRID,
+    .renderer = RENDER_TEXTURE,
+    .step = 0,
+    .memory = 256,
+    .percent = PERCENT,
+    .generation = 0,
+};
+
+#undef CELL
+#undef WIDTH
+#undef HEIGH
+#undef PERCENT
+
+/* ================================ */
+
+/**
+ * Advance a world by a generation on its grids, tile by tile.
+*/
+static void _World_evolve_grid(const World_t w) {
+
+    w->kernel = Kernel_select(World_current(w), &w->rule);
+
+    /* The pool is started once and kept for the life of the world */
+    if ((w->pool == NULL) && (w->threads != 1)) {
+        w->pool = Pool_new(w->threads);
+    }
+
+    /* So is the scheduler */
+    if ((w->sched == NULL) && ((w->sched = Sched_new(w->tiles, (w->pool != NULL) ? w->pool->size : 1)) == NULL)) {
+        return ;
+    }
+
+    /* Cells beyond the edges are read through the halo of the current generation, filled when the grid or the mode is new */
+    if (Grid_halo(World_current(w), w->type) == EXIT_FAILURE) {
+        return ;
+    }
+
+    /* The previous generation is overwritten by the next one, tile by tile. Tiles that cannot change are skipped ... */
+    Sched_run(w->sched, w->tiles, w->pool, w->kernel, &w->rule, World_previous(w), World_current(w));
+
+    /* ... which then becomes the current one */
+    w->parity = !w->parity;
+
+    w->generation++;
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Advance a HashLife world by 2^step generations and copy the window into the current grid.
+*/
+static void _World_evolve_quad(const World_t w) {
+
+    /* The plane is built from the current grid on the first step */
+    if (w->quad == NULL) {
+
+        if ((w->quad = Quad_new(w->memory << 20, &w->rule)) == NULL) {
+            return ;
+        }
+
+        if (Quad_import(w->quad, World_current(w)) == EXIT_FAILURE) {
+
+            Quad_destroy(&w->quad);
+
+            return ;
+        }
+    }
+
+    if (Quad_step(w->quad, w->step) == EXIT_FAILURE) {
+        return ;
+    }
+
+    Quad_export(w->quad, World_current(w));
+
+    Tiles_touch_all(w->tiles);
+
+    w->generation += (size_t) 1 << w->step;
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Advance a sparse world by a generation and copy the window into the current grid.
+*/
+static void _World_evolve_sparse(const World_t w) {
+
+    /* The plane is built from the current grid on the first step, which is where the window starts */
+    if (w->sparse == NULL) {
+
+        if ((w->sparse = Sparse_new(&w->rule)) == NULL) {
+            return ;
+        }
+
+        if (Sparse_import(w->sparse, World_current(w)) == EXIT_FAILURE) {
+
+            Sparse_destroy(&w->sparse);
+
+            return ;
+        }
+
+        w->top = 0;
+        w->left = 0;
+    }
+
+    if (Sparse_step(w->sparse) == EXIT_FAILURE) {
+        return ;
+    }
+
+    Sparse_export(w->sparse, World_current(w), w->top, w->left);
+
+    Tiles_touch_all(w->tiles);
+
+    w->generation++;
+
+    return ;
+}
+
+/**
+ * Build the settings of a world at generation `generation`: everything a world file holds but the cells.
+*/
+static cJSON* _World_settings(const World_t w, size_t generation) {
+
+    cJSON* root = NULL;
+    cJSON* data = NULL;
+    cJSON* array = NULL;
+
+    size_t i = 0;
+
+    if ((root = cJSON_CreateObject()) == NULL) {
+        return NULL;
+    }
+
+    /* ================================ */
+
+    data = (data = cJSON_CreateNumber(w->cell_size)) ? data : NULL;
+    cJSON_AddItemToObject(root, "cell_size", data);
+
+    data = (data = cJSON_CreateNumber(w->width)) ? data : NULL;
+    cJSON_AddItemToObject(root, "width", data);
+
+    data = (data = cJSON_CreateNumber(w->height)) ? data : NULL;
+    cJSON_AddItemToObject(root, "height", data);
+
+    data = (data = cJSON_CreateNumber(w->is_grid)) ? data : NULL;
+    cJSON_AddItemToObject(root, "is_grid", data);
+
+    data = (data = cJSON_CreateNumber(w->type)) ? data : NULL;
+    cJSON_AddItemToObject(root, "type", data);
+
+    data = (data = cJSON_CreateString(w->rule.name)) ? data : NULL;
+    cJSON_AddItemToObject(root, "rule", data);
+
+    data = (data = cJSON_CreateString((w->storage == GRID_BYTES) ? "bytes" : "bits")) ? data : NULL;
+    cJSON_AddItemToObject(root, "storage", data);
+
+    data = (data = cJSON_CreateNumber(w->map)) ? data : NULL;
+    cJSON_AddItemToObject(root, "map", data);
+
+    data = (data = cJSON_CreateNumber(w->rate)) ? data : NULL;
+    cJSON_AddItemToObject(root, "rate", data);
+
+    data = (data = cJSON_CreateNumber(w->threads)) ? data : NULL;
+    cJSON_AddItemToObject(root, "threads", data);
+
+    data = (data = cJSON_CreateString((w->engine == ENGINE_HASHLIFE) ? "hashlife" : (w->engine == ENGINE_SPARSE) ? "sparse" : "grid")) ? data : NULL;
+    cJSON_AddItemToObject(root, "engine", data);
+
+    data = (data = cJSON_CreateString(RENDERER[w->renderer])) ? data : NULL;
+    cJSON_AddItemToObject(root, "renderer", data);
+
+    data = (data = cJSON_CreateNumber(w->step)) ? data : NULL;
+    cJSON_AddItemToObject(root, "step", data);
+
+    data = (data = cJSON_CreateNumber(w->memory)) ? data : NULL;
+    cJSON_AddItemToObject(root, "memory", data);
+
+    data = (data = cJSON_CreateNumber(generation)) ? data : NULL;
+    cJSON_AddItemToObject(root, "generation", data);
+
+    data = (data = cJSON_CreateNumber(w->percent)) ? data : NULL;
+    cJSON_AddItemToObject(root, "percent", data);
+
+    if ((array = cJSON_CreateArray()) == NULL) {
+
+        return root;
+    }
+
+    for (i = 0; i < sizeof(w->c_color) / (sizeof(w->c_color[0])); i++) {
+
+        data = (data = cJSON_CreateNumber(w->c_color[i])) ? data : NULL;
+        cJSON_AddItemToArray(array, data);
+    }
+
+    cJSON_AddItemToObject(root, "cell_color", array);
+
+    if ((array = cJSON_CreateArray()) == NULL) {
+
+        return root;
+    }
+
+    for (i = 0; i < sizeof(w->g_color) / (sizeof(w->g_color[0])); i++) {
+
+        data = (data = cJSON_CreateNumber(w->g_color[i])) ? data : NULL;
+        cJSON_AddItemToArray(array, data);
+    }
+
+    cJSON_AddItemToObject(root, "grid_color", array);
+
+    if ((array = cJSON_CreateArray()) == NULL) {
+
+        return root;
+    }
+
+    for (i = 0; i < sizeof(w->bg_color) / (sizeof(w->bg_color[0])); i++) {
+
+        data = (data = cJSON_CreateNumber(w->bg_color[i])) ? data : NULL;
+        cJSON_AddItemToArray(array, data);
+    }
+
+    cJSON_AddItemToObject(root, "bg_color", array);
+
+    /* ================================ */
+    /* ====== SAVING TEXT COLOR ======= */
+    /* ================================ */
+
+    if ((array = cJSON_CreateArray()) == NULL) {
+
+        return root;
+    }
+
+    for (i = 0; i < sizeof(w->text_color) / (sizeof(w->text_color[0])); i++) {
+
+        data = (data = cJSON_CreateNumber(w->text_color[i])) ? data : NULL;
+        cJSON_AddItemToArray(array, data);
+    }
+
+    cJSON_AddItemToObject(root, "text_color", array);
+
+    return root;
+}
+
+/* ================================ */
+
+/**
+ * Build the path of the snapshot saved with the world file `filename`: `filename` with `SNAPSHOT_EXT` in place of ".json".
+*/
+static void _World_snapshot(char* path, const char* filename) {
+
+    snprintf(path, MAX_PATH, "%.*s" SNAPSHOT_EXT, (int) ((strstr(filename, ".json") != NULL) ? (size_t) (strstr(filename, ".json") - filename) : strlen(filename)), filename);
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Hand the generation `generation`, held by `*g`, over to the autosave. With `copy` set, `*g` is copied instead of swapped for a spare grid.
+*/
+static void _World_autosave(const World_t w, Grid_t* g, int copy, size_t generation) {
+
+    cJSON* root = NULL;
+    cJSON* data = NULL;
+
+    Snapshot snapshot = {.encoding = (w->map) ? SNAPSHOT_LINES : SNAPSHOT_BITS, .type = w->type, .generation = generation};
+
+    memcpy(snapshot.rule, w->rule.name, RULE_NAME);
+
+    /* Only the settings are printed here; the cells are written by the autosave thread */
+    if ((root = _World_settings(w, generation)) == NULL) {
+        return ;
+    }
+
+    data = (data = cJSON_CreateString((strrchr(w->autosave->snapshot, '/') != NULL) ? strrchr(w->autosave->snapshot, '/') + 1 : w->autosave->snapshot)) ? data : NULL;
+    cJSON_AddItemToObject(root, "snapshot", data);
+
+    Autosave_take(w->autosave, g, copy, &snapshot, cJSON_Print(root));
+
+    cJSON_Delete(root);
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Fill the colors of the `RULE_STATES` states: live cells have the cell color, and decaying ones fade from it
+ * towards the background color as they age. States beyond the rule, left by another one, are drawn as alive.
+*/
+static void _World_palette(const World_t world, unsigned char (*palette)[4]) {
+
+    unsigned state = 0;
+    unsigned i = 0;
+
+    for (state = 1; state < RULE_STATES; state++) {
+
+        memcpy(palette[state], world->c_color, sizeof(world->c_color));
+
+        /* The last state is a step short of the background, so it still shows */
+        for (i = 0; (state < world->rule.states) && (i < 4); i++) {
+            palette[state][i] = (unsigned char) (world->c_color[i] + ((int) world->bg_color[i] - (int) world->c_color[i]) * (int) (state - 1) / (int) world->rule.states);
+        }
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Draw the cells through the texture of the world, and count the renderer calls into `draws`.
+*/
+static int _World_present_texture(const World_t world, SDL_Renderer* renderer, const Grid_t g, const unsigned char (*palette)[4], size_t* draws) {
+
+    size_t locks = 0;
+
+    if ((world->view == NULL) && ((world->view = View_new(renderer, world->rows, world->columns)) == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    locks = world->view->locks;
+
+    if (View_update(world->view, g, palette, world->rule.states) == EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    View_draw(world->view, renderer, world->cell_size);
+
+    *draws = world->view->locks - locks + 1;
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Add the rectangle covering the columns `left` .. `right - 1` of the row `row` to the rectangles of a frame.
+*/
+static int _World_rect(const World_t world, size_t* count, size_t row, size_t left, size_t right) {
+
+    SDL_Rect* rects = NULL;
+
+    size_t capacity = 0;
+
+    /* The buffer is kept, so it only grows during the first frames */
+    if (*count == world->capacity) {
+
+        capacity = (world->capacity > 0) ? 2 * world->capacity : 1024;
+
+        if ((rects = (SDL_Rect*) realloc(world->rects, capacity * sizeof(SDL_Rect))) == NULL) {
+            return EXIT_FAILURE;
+        }
+
+        world->rects = rects;
+        world->capacity = capacity;
+    }
+
+    world->rects[(*count)++] = (SDL_Rect) {
+        .x = (int) (left * world->cell_size),
+        .y = (int) (row * world->cell_size),
+        .w = (int) ((right - left) * world->cell_size),
+        .h = (int) world->cell_size
+    };
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Draw every run of cells in the same state of a byte row as a single rectangle, with a call per state.
+ * Runs are counted per state first, so that a second pass places them straight into the spans drawn together.
+*/
+static int _World_present_states(const World_t world, SDL_Renderer* renderer, const Grid_t g, const unsigned char (*palette)[4], size_t* draws) {
+
+    /* Number of runs in every state, then where the next one of them goes */
+    size_t counts[RULE_STATES] = {0};
+    size_t offsets[RULE_STATES] = {0};
+
+    size_t total = 0;
+
+    const unsigned char* cells = NULL;
+
+    SDL_Rect* rects = NULL;
+
+    size_t row = 0;
+    size_t left = 0;
+    size_t right = 0;
+
+    unsigned state = 0;
+
+    for (row = 0; row < g->rows; row++) {
+
+        for (cells = Grid_bytes(g, row), left = 0; left < g->columns; left = right) {
+
+            for (right = left + 1; (right < g->columns) && (cells[right] == cells[left]); right++) ;
+
+            counts[cells[left]]++;
+        }
+    }
+
+    /* Dead runs are not drawn */
+    for (state = 1; state < RULE_STATES; state++) {
+
+        offsets[state] = total;
+        total += counts[state];
+    }
+
+    if (total > world->capacity) {
+
+        if ((rects = (SDL_Rect*) realloc(world->rects, total * sizeof(SDL_Rect))) == NULL) {
+            return EXIT_FAILURE;
+        }
+
+        world->rects = rects;
+        world->capacity = total;
+    }
+
+    for (row = 0; row < g->rows; row++) {
+
+        for (cells = Grid_bytes(g, row), left = 0; left < g->columns; left = right) {
+
+            for (right = left + 1; (right < g->columns) && (cells[right] == cells[left]); right++) ;
+
+            if (cells[left] == 0) {
+                continue ;
+            }
+
+            world->rects[offsets[cells[left]]++] = (SDL_Rect) {
+                .x = (int) (left * world->cell_size),
+                .y = (int) (row * world->cell_size),
+                .w = (int) ((right - left) * world->cell_size),
+                .h = (int) world->cell_size
+            };
+        }
+    }
+
+    *draws = 0;
+
+    for (state = 1; state < RULE_STATES; state++) {
+
+        if (counts[state] == 0) {
+            continue ;
+        }
+
+        SDL_SetRenderDrawColor(renderer, palette[state][0], palette[state][1], palette[state][2], palette[state][3]);
+
+        SDL_RenderFillRects(renderer, world->rects + offsets[state] - counts[state], (int) counts[state]);
+
+        (*draws)++;
+    }
+
+    SDL_SetRenderDrawColor(renderer, palette[1][0], palette[1][1], palette[1][2], palette[1][3]);
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Draw every run of live cells of a row as a single rectangle, all of them in a single call, or a call per state with decaying ones.
+*/
+static int _World_present_rects(const World_t world, SDL_Renderer* renderer, const Grid_t g, const unsigned char (*palette)[4], size_t* draws) {
+
+    size_t count = 0;
+
+    size_t row = 0;
+    size_t word = 0;
+    size_t column = 0;
+
+    /* The run being gathered: the columns `left` .. `right - 1`. Runs of a bit-packed row may go on into the next word */
+    size_t left = 0;
+    size_t right = 0;
+
+    /* First live cell of a word, and the length of the run starting there */
+    size_t first = 0;
+    size_t length = 0;
+
+    uint64_t bits = 0;
+
+    if ((world->rule.states > 2) && (g->format == GRID_BYTES)) {
+        return _World_present_states(world, renderer, g, palette, draws);
+    }
+
+    for (row = 0; row < g->rows; row++) {
+
+        left = right = 0;
+
+        if (g->format == GRID_BYTES) {
+
+            for (column = 0; column < g->columns; column = right) {
+
+                for (left = column; (left < g->columns) && !Grid_bytes(g, row)[left]; left++) ;
+                for (right = left; (right < g->columns) && Grid_bytes(g, row)[right]; right++) ;
+
+                if ((right > left) && (_World_rect(world, &count, row, left, right) == EXIT_FAILURE)) {
+                    return EXIT_FAILURE;
+                }
+            }
+
+            continue ;
+        }
+
+        /* Dead words are skipped at once; padding bits are always 0 */
+        for (word = 0; word < g->words; word++) {
+
+            for (bits = Grid_row(g, row)[word]; bits; bits &= (first + length < GRID_WORD) ? ~UINT64_C(0) << (first + length) : 0) {
+
+                first = __builtin_ctzll(bits);
+                length = (~(bits >> first) == 0) ? GRID_WORD : (size_t) __builtin_ctzll(~(bits >> first));
+
+                /* A run reaching the end of the previous word goes on */
+                if ((right > left) && (word * GRID_WORD + first == right)) {
+
+                    right += length;
+
+                    continue ;
+                }
+
+                if ((right > left) && (_World_rect(world, &count, row, left, right) == EXIT_FAILURE)) {
+                    return EXIT_FAILURE;
+                }
+
+                left = word * GRID_WORD + first;
+                right = left + length;
+            }
+        }
+
+        if ((right > left) && (_World_rect(world, &count, row, left, right) == EXIT_FAILURE)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (count > 0) {
+        SDL_RenderFillRects(renderer, world->rects, (int) count);
+    }
+
+    *draws = (count > 0);
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Draw a rectangle per live or decaying cell.
+*/
+static int _World_present_cells(const World_t world, const Window_t w, const Grid_t g, const unsigned char (*palette)[4], size_t* draws) {
+
+    size_t row, word, column;
+    SDL_Rect cell = {.w = world->cell_size, .h = world->cell_size};
+
+    /* State whose color is set */
+    unsigned char state = 1;
+
+    /* Live cells of a single word */
+    uint64_t bits = 0;
+
+    *draws = 0;
+
+    for (row = 0; row < world->rows; row++) {
+
+        cell.y = row * world->cell_size;
+
+        if (g->format == GRID_BYTES) {
+
+            for (column = 0; column < world->columns; column++) {
+
+                cell.x = column * world->cell_size;
+
+                if (Grid_bytes(g, row)[column]) {
+
+                    /* Decaying cells change the color only when the state does */
+                    if (Grid_bytes(g, row)[column] != state) {
+
+                        state = Grid_bytes(g, row)[column];
+
+                        LilEn_set_colorRGB(palette[state][0], palette[state][1], palette[state][2], palette[state][3]);
+                    }
+
+                    LilEn_draw_rect(w, &cell);
+
+                    (*draws)++;
+                }
+            }
+
+            continue ;
+        }
+
+        for (word = 0; word < g->words; word++) {
+
+            /* Dead words are skipped at once; padding bits are always 0 */
+            for (bits = Grid_row(g, row)[word]; bits; bits &= bits - 1) {
+
+                cell.x = (word * GRID_WORD + __builtin_ctzll(bits)) * world->cell_size;
+
+                LilEn_draw_rect(w, &cell);
+
+                (*draws)++;
+            }
+        }
+    }
+
+    if (state != 1) {
+        LilEn_set_colorRGB(palette[1][0], palette[1][1], palette[1][2], palette[1][3]);
+    }
 
-#undef CELL
-#undef WIDTH
-#undef HEIGH
-#undef PERCENT
+    return EXIT_SUCCESS;
+}
 
 /* ================================================================ */
 /* ============================ EXTERN ============================ */
@@ -68,6 +701,8 @@ World_t World_new(void) {
     World_t world = NULL;
     FILE* file = NULL;
 
+    size_t i = 0;
+
     if ((world = _World_alloc()) == NULL) {
         return NULL;
     }
@@ -90,11 +725,14 @@ World_t World_new(void) {
 
     /* ================================ */
 
-    if ((world->current = allocate_2D_array(world->rows, world->columns)) == NULL) {
-        goto CLEANUP;
+    for (i = 0; i < 2; i++) {
+
+        if ((world->generations[i] = Grid_new(world->rows, world->columns, world->storage)) == NULL) {
+            goto CLEANUP;
+        }
     }
 
-    if ((world->previous = allocate_2D_array(world->rows, world->columns)) == NULL) {
+    if ((world->tiles = Tiles_new(world->rows, world->columns)) == NULL) {
         goto CLEANUP;
     }
 
@@ -132,6 +770,16 @@ int World_load(const char* filename, const World_t w) {
     /* A single piece of information extracted from a root */
     cJSON* data = NULL;
 
+    char path[MAX_PATH];
+    Snapshot snapshot;
+
+    /* Mapped current grid */
+    Grid_t g = NULL;
+
+    int status = EXIT_FAILURE;
+
+    size_t i = 0;
+
     if (filename == NULL) {
         return EXIT_FAILURE;
     }
@@ -172,6 +820,46 @@ int World_load(const char* filename, const World_t w) {
         w->height -= r;
     }
 
+    /* ======================= Retrieving the rule ===================== */
+    data = (cJSON*) Data_read("rule", root, cJSON_IsString);
+
+    if ((data == NULL) || (Rule_parse(&w->rule, data->valuestring) == EXIT_FAILURE)) {
+        w->rule = WORLD.rule;
+    }
+
+    /* =================== Retrieving grid storage =================== */
+    data = (cJSON*) Data_read("storage", root, cJSON_IsString);
+    w->storage = (data && (strcmp(data->valuestring, "bytes") == 0)) ? GRID_BYTES : WORLD.storage;
+
+    data = (cJSON*) Data_read("map", root, cJSON_IsNumber);
+    w->map = (data) ? data->valueint : WORLD.map;
+
+    /* Decaying states take a byte per cell */
+    if (w->rule.states > 2) {
+        w->storage = GRID_BYTES;
+    }
+
+    /* ============ The file may describe a different world =========== */
+    if ((World_current(w) != NULL) && ((World_current(w)->rows != w->rows) || (World_current(w)->columns != w->columns) || (World_current(w)->format != w->storage))) {
+
+        /* The tiles do not fit anymore */
+        Sched_destroy(&w->sched);
+        Tiles_destroy(&w->tiles);
+
+        for (i = 0; i < 2; i++) {
+
+            Grid_destroy(&w->generations[i]);
+
+            if ((w->generations[i] = Grid_new(w->rows, w->columns, w->storage)) == NULL) {
+                goto CLEANUP;
+            }
+        }
+
+        if ((w->tiles = Tiles_new(w->rows, w->columns)) == NULL) {
+            goto CLEANUP;
+        }
+    }
+
     /* ==================== Retrieving start info ===================== */
     data = (cJSON*) Data_read("percent", root, cJSON_IsNumber);
     w->percent = (data) ? data->valuedouble : WORLD.percent;
@@ -184,13 +872,43 @@ int World_load(const char* filename, const World_t w) {
     data = (cJSON*) Data_read("rate", root, cJSON_IsNumber);
     w->rate = (data) ? data->valueint : WORLD.rate;
 
+    /* ================== Retrieving number of threads ================ */
+    data = (cJSON*) Data_read("threads", root, cJSON_IsNumber);
+    w->threads = (data && (data->valueint >= 0)) ? data->valueint : WORLD.threads;
+
+    /* ===================== Retrieving the engine ==================== */
+    data = (cJSON*) Data_read("engine", root, cJSON_IsString);
+    w->engine = (data && (strcmp(data->valuestring, "hashlife") == 0)) ? ENGINE_HASHLIFE : (data && (strcmp(data->valuestring, "sparse") == 0)) ? ENGINE_SPARSE : WORLD.engine;
+
+    /* Planes only evolve two-state rules of range 1, and cannot hold the empty space a rule with B0 gives birth to */
+    if (!Rule_is_planar(&w->rule)) {
+        w->engine = ENGINE_GRID;
+    }
+
+    /* ==================== Retrieving the renderer ================== */
+    data = (cJSON*) Data_read("renderer", root, cJSON_IsString);
+    w->renderer = WORLD.renderer;
+
+    for (i = 0; (data != NULL) && (i < RENDERERS); i++) {
+
+        if (strcmp(data->valuestring, RENDERER[i]) == 0) {
+            w->renderer = (int) i;
+        }
+    }
+
+    data = (cJSON*) Data_read("step", root, cJSON_IsNumber);
+    w->step = (data && (data->valueint >= 0) && (data->valueint + 3 <= QUAD_LEVELS)) ? (unsigned) data->valueint : WORLD.step;
+
+    data = (cJSON*) Data_read("memory", root, cJSON_IsNumber);
+    w->memory = (data && (data->valueint >= 0)) ? (size_t) data->valueint : WORLD.memory;
+
     /* ==================== Retrieving world type ===================== */
     data = (cJSON*) Data_read("type", root, cJSON_IsNumber);
-    w->type = (data) ? data->valueint : WORLD.type;
+    w->type = (data && (data->valueint >= GRID_TORUS) && (data->valueint <= GRID_ALIVE)) ? data->valueint : WORLD.type;
 
     /* ================= Retrieving world generation ================== */
     data = (cJSON*) Data_read("generation", root, cJSON_IsNumber);
-    w->generation = (data) ? (size_t) data->valueint : WORLD.generation;
+    w->generation = (data) ? (size_t) data->valuedouble : WORLD.generation;
 
     /* ================================ */
     /* ====== READING GRID COLOR ====== */
@@ -273,8 +991,49 @@ int World_load(const char* filename, const World_t w) {
         w->text_color[2] = WORLD.text_color[3];
     }
 
-    /* Loading the current generation */
-    load_2D_array(root, "current", w->current, w->rows, w->columns);
+    /* Loading the current generation. Files written before snapshots hold it as a JSON array */
+    data = (cJSON*) Data_read("snapshot", root, cJSON_IsString);
+
+    if (data != NULL) {
+
+        _World_sibling(path, filename, data->valuestring);
+
+        /* A mapped snapshot of the same size becomes the current grid. Pages are read as the world touches them */
+        g = ((w->map) && (w->storage == GRID_BITS)) ? Snapshot_map(path, &snapshot) : NULL;
+
+        if ((g != NULL) && (g->rows == w->rows) && (g->columns == w->columns)) {
+
+            Grid_destroy(&World_current(w));
+            World_current(w) = g;
+
+            status = EXIT_SUCCESS;
+        }
+        else {
+
+            Grid_destroy(&g);
+
+            status = Snapshot_load(path, &snapshot, World_current(w));
+        }
+
+        if (status == EXIT_SUCCESS) {
+
+            w->generation = snapshot.generation;
+
+            /* A foreign or corrupt header keeps the type read from the file */
+            if ((snapshot.type >= GRID_TORUS) && (snapshot.type <= GRID_ALIVE)) {
+                w->type = (int) snapshot.type;
+            }
+        }
+    }
+    else {
+        Grid_load(root, "current", World_current(w));
+    }
+
+    Tiles_touch_all(w->tiles);
+
+    /* The plane is rebuilt from the loaded grid */
+    Quad_destroy(&w->quad);
+    Sparse_destroy(&w->sparse);
 
     /* ================================ */
 
@@ -302,6 +1061,8 @@ int World_load(const char* filename, const World_t w) {
 
 void World_log(const World_t w) {
 
+    size_t i = 0;
+
     if (w == NULL) {
         return ;
     }
@@ -315,14 +1076,46 @@ void World_log(const World_t w) {
     printf("%-16s: %ld\n", "number of cells", w->columns * w->rows);
     printf("%-16s: %.0f (%.2f)\n", "rate", 1.0f / w->clock->time, w->clock->time);
     printf("%-16s: %ld\n", "generation", w->generation);
+    printf("%-16s: %d\n", "threads", (w->pool) ? (int) w->pool->size : w->threads);
 
     printf("%-16s: %s (%d)\n", "type", (w->type == 1) ? "wrap around" : (w->type == 2) ? "dead" : "alive", w->type);
+    printf("%-16s: %s\n", "rule", w->rule.name);
+    printf("%-16s: %s\n", "storage", (w->storage == GRID_BYTES) ? "bytes" : "bits");
+    printf("%-16s: %s\n", "engine", (w->engine == ENGINE_HASHLIFE) ? "hashlife" : (w->engine == ENGINE_SPARSE) ? "sparse" : "grid");
+
+    if (w->engine == ENGINE_HASHLIFE) {
+        printf("%-16s: %u (%ld generations)\n", "step", w->step, (size_t) 1 << w->step);
+    }
+
+    printf("%-16s: %s\n", "renderer", RENDERER[w->renderer]);
+
+    /* Renderers used during the run, side by side */
+    for (i = 0; i < RENDERERS; i++) {
+
+        if (w->frames[i] > 0) {
+            printf("%-16s: %ld frames, %.1f calls/frame, %.3f ms/frame\n", RENDERER[i], w->frames[i], (double) w->draws[i] / w->frames[i], 1e3 * w->drawing[i] / w->frames[i]);
+        }
+    }
 
     printf("%-16s: [%d, %d, %d, %d]\n", "cell color", w->c_color[0], w->c_color[1], w->c_color[2], w->c_color[3]);
     printf("%-16s: [%d, %d, %d, %d]\n", "grid color", w->g_color[0], w->g_color[1], w->g_color[2], w->g_color[3]);
     printf("%-16s: [%d, %d, %d, %d]\n", "text color", w->text_color[0], w->text_color[1], w->text_color[2], w->text_color[3]);
     printf("%-16s: [%d, %d, %d, %d]\n", "BG color", w->bg_color[0], w->bg_color[1], w->bg_color[2], w->bg_color[3]);
 
+    if (w->tiles != NULL) {
+        printf("%-16s: %ld x %ld (%d x %d cells)\n", "tiles", w->tiles->rows, w->tiles->columns, TILE_ROWS, TILE_COLUMNS);
+    }
+
+    Sched_log(w->sched);
+
+    Quad_log(w->quad);
+
+    Sparse_log(w->sparse);
+
+    Record_log(w->record);
+
+    Autosave_log(w->autosave);
+
     return ;
 }
 
@@ -334,9 +1127,25 @@ int World_destroy(World_t* w) {
         return EXIT_FAILURE;
     }
 
-    deallocate_2D_array(&(*w)->current, (*w)->rows);
+    Grid_destroy(&(*w)->generations[0]);
+
+    Grid_destroy(&(*w)->generations[1]);
+
+    Pool_destroy(&(*w)->pool);
+
+    Sched_destroy(&(*w)->sched);
+
+    Tiles_destroy(&(*w)->tiles);
+
+    Quad_destroy(&(*w)->quad);
 
-    deallocate_2D_array(&(*w)->previous, (*w)->rows);
+    Sparse_destroy(&(*w)->sparse);
+
+    Record_destroy(&(*w)->record);
+
+    Autosave_destroy(&(*w)->autosave);
+
+    free((*w)->rects);
 
     Timer_destroy(&(*w)->clock);
 
@@ -362,7 +1171,7 @@ void World_log_generation(const World_t w) {
 
         for (column = 0; column < w->columns; column++) {
 
-            printf("%d", w->current[row][column]);
+            printf("%d", Grid_get(World_current(w), row, column));
 
             if (column + 1 < w->columns) {
                 printf(", ");
@@ -379,8 +1188,16 @@ void World_log_generation(const World_t w) {
 
 void World_present(const World_t world, const Window_t w) {
 
-    size_t row, column;
-    SDL_Rect cell = {.w = world->cell_size, .h = world->cell_size};
+    struct timespec start, end;
+
+    SDL_Renderer* renderer = NULL;
+
+    Grid_t g = NULL;
+
+    size_t draws = 0;
+
+    /* Color of every state */
+    unsigned char palette[RULE_STATES][4];
 
     if ((w == NULL) && (g_window == NULL)) {
         return ;
@@ -390,18 +1207,56 @@ void World_present(const World_t world, const Window_t w) {
         return ;
     }
 
-    for (column = 0; column < world->columns; column++) {
+    /* The latest generation handed over by the simulation thread, if any */
+    if ((g = Triple_acquire(world->handoff, &world->shown)) == NULL) {
 
-        cell.x = column * world->cell_size;
+        g = World_current(world);
 
-        for (row = 0; row < world->rows; row++) {
+        world->shown = world->generation;
+    }
 
-            cell.y = row * world->cell_size;
+    renderer = (w != NULL) ? w->renderer : g_window->renderer;
 
-            if (world->current[row][column]) {
-                LilEn_draw_rect(w, &cell);
-            }
-        }
+    _World_palette(world, palette);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    /* A renderer that cannot draw hands over to the next one */
+    if ((world->renderer == RENDER_TEXTURE) && (_World_present_texture(world, renderer, g, (const unsigned char (*)[4]) palette, &draws) == EXIT_FAILURE)) {
+        world->renderer = RENDER_RECTS;
+    }
+
+    if ((world->renderer == RENDER_RECTS) && (_World_present_rects(world, renderer, g, (const unsigned char (*)[4]) palette, &draws) == EXIT_FAILURE)) {
+        world->renderer = RENDER_CELLS;
+    }
+
+    if (world->renderer == RENDER_CELLS) {
+        _World_present_cells(world, w, g, (const unsigned char (*)[4]) palette, &draws);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    world->frames[world->renderer]++;
+    world->draws[world->renderer] += draws;
+    world->drawing[world->renderer] += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    return ;
+}
+
+/* ================================================================ */
+
+void World_present_grid(const World_t world, const Window_t w) {
+
+    if (world == NULL) {
+        return ;
+    }
+
+    /* Lines are drawn into a texture once; without one, they are drawn on every frame */
+    if (Overlay_draw(&world->overlay, w, world->cell_size, world->g_color) == EXIT_FAILURE) {
+
+        LilEn_set_colorRGB(world->g_color[0], world->g_color[1], world->g_color[2], world->g_color[3]);
+
+        Window_display_grid(w, world->cell_size);
     }
 
     return ;
@@ -431,9 +1286,14 @@ void World_randomize(const World_t w, int c) {
         row = RAND_RANGE(0, w->rows - 1);
         column = RAND_RANGE(0, w->columns - 1);
 
-        w->current[row][column] = 1;
+        Grid_set(World_current(w), row, column, 1);
     }
 
+    Tiles_touch_all(w->tiles);
+
+    Quad_destroy(&w->quad);
+    Sparse_destroy(&w->sparse);
+
     return ;
 }
 
@@ -441,203 +1301,212 @@ void World_randomize(const World_t w, int c) {
 
 void World_evolve(const World_t w) {
 
-    int row = 0;
-    int rows = 0;
-
-    int column = 0;
-    int columns = 0;
-
-    /* Accumulator */
-    int acc = 0;
+    int due = 0;
 
     if (w == NULL) { 
         return ;
     }
 
-    rows = w->rows;
-    columns = w->columns;
+    if (w->engine == ENGINE_HASHLIFE) {
+        _World_evolve_quad(w);
+    }
+    else if (w->engine == ENGINE_SPARSE) {
+        _World_evolve_sparse(w);
+    }
+    else {
+
+        due = Autosave_due(w->autosave, w->generation);
 
-    swap_2D_array(w->current, w->previous, w->rows, w->columns);
+        _World_evolve_grid(w);
 
-    for (row = 0; row < rows; row++) {
+        /* The generation due is now the previous one, which is not read anymore: its grid is swapped for a spare one instead of copied.
+         * The spare grid holds an older generation, so every tile is evolved once more */
+        if (due) {
 
-        for (column = 0; column < columns; column++) {
+            _World_autosave(w, &World_previous(w), 0, w->generation - 1);
 
-            acc 
-                = w->previous[(row - 1 < 0) ? rows - 1 : row - 1][column]
-                + w->previous[(row - 1 < 0) ? rows - 1 : row - 1][(column + 1 >= columns) ? 0 : column + 1]
-                + w->previous[row][(column + 1 >= columns) ? 0 : column + 1]
-                + w->previous[(row + 1 >= rows) ? 0 : row + 1][(column + 1 >= columns) ? 0 : column + 1]
-                + w->previous[(row + 1 >= rows) ? 0 : row + 1][column]
-                + w->previous[(row + 1 >= rows) ? 0 : row + 1][(column - 1 < 0) ? columns - 1 : column - 1]
-                + w->previous[row][((column - 1 <= 0) ? columns - 1 : column - 1)]
-                + w->previous[(row - 1 < 0) ? rows - 1 : row - 1][(column - 1 < 0) ? columns - 1 : column - 1];
-            
-            /* Any live cell with fewer than two live neighbours dies, as if by underpopulation. */
-            if (w->previous[row][column] == 1 && acc < 2) {
-                w->current[row][column] = 0;
-            }
-            /* Any live cell with two or three live neighbours lives on to the next generation. */
-            else if ((w->previous[row][column] == 1) && (acc == 2 || 2 == 3)) {
-                w->current[row][column] = 1;
-            }
-            /* Any live cell with more than three live neighbours dies, as if by overpopulation. */
-            else if (w->previous[row][column] == 1 && acc > 3) {
-                w->current[row][column] = 0;
-            }
-            /* Any dead cell with exactly three live neighbours becomes a live cell, as if by reproduction. */
-            else if (w->previous[row][column] == 0 && acc == 3) {
-                w->current[row][column] = 1;
-            }
-            else {
-                w->current[row][column]= w->previous[row][column];
-            }
+            Tiles_touch_all(w->tiles);
         }
     }
 
-    w->generation++;
+    /* The other engines overwrite the current grid in place, so it is copied */
+    if ((w->engine != ENGINE_GRID) && Autosave_due(w->autosave, w->generation)) {
+        _World_autosave(w, &World_current(w), 1, w->generation);
+    }
+
+    Record_push(w->record, World_current(w), w->generation);
 
     return ;
 }
 
 /* ================================================================ */
 
-int World_save(const char* filename, const World_t w) {
-
-    FILE* file = NULL;
-    cJSON* root = NULL;
-    cJSON* data = NULL;
-    cJSON* array = NULL;
+int World_autosave(const World_t w, const char* filename, size_t every, int seconds) {
 
-    size_t i = 0;
+    char path[MAX_PATH];
 
-    if (w == NULL) {
+    if ((w == NULL) || (filename == NULL)) {
         return EXIT_FAILURE;
     }
 
-    if ((root = cJSON_CreateObject()) == NULL) {
-        return EXIT_FAILURE;
-    }
+    _World_snapshot(path, filename);
 
-    if ((file = file_create(filename)) == NULL) {
-        
-        cJSON_Delete(root);
+    Autosave_destroy(&w->autosave);
 
-        return EXIT_FAILURE;
-    }
+    return ((w->autosave = Autosave_new(filename, path, w->generation, every, seconds)) != NULL) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-    /* ================================ */
+/* ================================================================ */
 
-    data = (data = cJSON_CreateNumber(w->cell_size)) ? data : NULL;
-    cJSON_AddItemToObject(root, "cell_size", data);
+int World_import(const World_t w, const char* filename, int64_t top, int64_t left) {
 
-    data = (data = cJSON_CreateNumber(w->width)) ? data : NULL;
-    cJSON_AddItemToObject(root, "width", data);
+    Pattern pattern;
+    Rule rule;
 
-    data = (data = cJSON_CreateNumber(w->height)) ? data : NULL;
-    cJSON_AddItemToObject(root, "height", data);
+    if ((w == NULL) || (Pattern_load(filename, World_current(w), top, left, &pattern) == EXIT_FAILURE)) {
+        return EXIT_FAILURE;
+    }
 
-    data = (data = cJSON_CreateNumber(w->is_grid)) ? data : NULL;
-    cJSON_AddItemToObject(root, "is_grid", data);
+    if (pattern.dropped > 0) {
+        printf("%s: %ld cells outside of the world\n", filename, pattern.dropped);
+    }
 
-    data = (data = cJSON_CreateNumber(w->type)) ? data : NULL;
-    cJSON_AddItemToObject(root, "type", data);
+    /* The pattern evolves under the rule of the world, whichever one it was drawn for */
+    if (pattern.rule[0] != '\0') {
 
-    data = (data = cJSON_CreateNumber(w->rate)) ? data : NULL;
-    cJSON_AddItemToObject(root, "rate", data);
+        if (Rule_parse(&rule, pattern.rule) == EXIT_FAILURE) {
+            printf("%s: unknown rule %s, evolved under %s\n", filename, pattern.rule, w->rule.name);
+        }
+        else if (strcmp(rule.name, w->rule.name) != 0) {
+            printf("%s: drawn for %s, evolved under %s\n", filename, rule.name, w->rule.name);
+        }
+    }
 
-    data = (data = cJSON_CreateNumber(w->generation)) ? data : NULL;
-    cJSON_AddItemToObject(root, "generation", data);
+    Tiles_touch_all(w->tiles);
 
-    data = (data = cJSON_CreateNumber(w->percent)) ? data : NULL;
-    cJSON_AddItemToObject(root, "percent", data);
+    /* The plane is rebuilt from the grid */
+    Quad_destroy(&w->quad);
+    Sparse_destroy(&w->sparse);
 
-    if ((array = cJSON_CreateArray()) == NULL) {
+    return EXIT_SUCCESS;
+}
 
-        fprintf(file, "%s", cJSON_Print(root));
+/* ================================================================ */
 
-        cJSON_Delete(root);
-        fclose(file);
+int World_export(const World_t w, const char* filename) {
 
+    if (w == NULL) {
         return EXIT_FAILURE;
     }
 
-    for (i = 0; i < sizeof(w->c_color) / (sizeof(w->c_color[0])); i++) {
+    return Pattern_save(filename, World_current(w), w->rule.name);
+}
 
-        data = (data = cJSON_CreateNumber(w->c_color[i])) ? data : NULL;
-        cJSON_AddItemToArray(array, data);
+/* ================================================================ */
+
+void World_pan(const World_t w, int64_t rows, int64_t columns) {
+
+    if ((w == NULL) || (w->sparse == NULL)) {
+        return ;
     }
 
-    cJSON_AddItemToObject(root, "cell_color", array);
+    w->top += rows;
+    w->left += columns;
 
-    if ((array = cJSON_CreateArray()) == NULL) {
+    Sparse_export(w->sparse, World_current(w), w->top, w->left);
 
-        fprintf(file, "%s", cJSON_Print(root));
+    Tiles_touch_all(w->tiles);
 
-        cJSON_Delete(root);
-        fclose(file);
+    return ;
+}
 
-        return EXIT_FAILURE;
-    }
+/* ================================================================ */
 
-    for (i = 0; i < sizeof(w->g_color) / (sizeof(w->g_color[0])); i++) {
+int World_save(const char* filename, const World_t w) {
 
-        data = (data = cJSON_CreateNumber(w->g_color[i])) ? data : NULL;
-        cJSON_AddItemToArray(array, data);
-    }
+    FILE* file = NULL;
+    cJSON* root = NULL;
+    cJSON* data = NULL;
 
-    cJSON_AddItemToObject(root, "grid_color", array);
+    char path[MAX_PATH];
+    Snapshot snapshot;
 
-    if ((array = cJSON_CreateArray()) == NULL) {
+    /* Both files are written under a temporary name first */
+    char snapshot_temp[MAX_PATH + sizeof(SNAPSHOT_TEMP)] = "";
+    char temp[MAX_PATH + sizeof(SNAPSHOT_TEMP)];
 
-        fprintf(file, "%s", cJSON_Print(root));
+    char* settings = NULL;
 
-        cJSON_Delete(root);
-        fclose(file);
+    int status = EXIT_SUCCESS;
 
+    if ((filename == NULL) || (w == NULL)) {
         return EXIT_FAILURE;
     }
 
-    for (i = 0; i < sizeof(w->bg_color) / (sizeof(w->bg_color[0])); i++) {
+    /* An autosave into the same files must not land after this save */
+    Autosave_wait(w->autosave);
 
-        data = (data = cJSON_CreateNumber(w->bg_color[i])) ? data : NULL;
-        cJSON_AddItemToArray(array, data);
+    if ((root = _World_settings(w, w->generation)) == NULL) {
+        return EXIT_FAILURE;
     }
 
-    cJSON_AddItemToObject(root, "bg_color", array);
+    /* Cells go into a binary snapshot next to the file; the file only names it */
+    if (World_current(w) != NULL) {
 
-    /* ================================ */
-    /* ====== SAVING TEXT COLOR ======= */
-    /* ================================ */
+        _World_snapshot(path, filename);
 
-    if ((array = cJSON_CreateArray()) == NULL) {
+        snprintf(snapshot_temp, sizeof(snapshot_temp), "%s" SNAPSHOT_TEMP, path);
 
-        fprintf(file, "%s", cJSON_Print(root)); 
+        snapshot = (Snapshot) {.encoding = (w->map) ? SNAPSHOT_LINES : SNAPSHOT_BITS, .type = w->type, .generation = w->generation};
 
-        cJSON_Delete(root);
-        fclose(file);
+        memcpy(snapshot.rule, w->rule.name, RULE_NAME);
 
-        return EXIT_FAILURE;
+        /* Without its cells, the file must not be replaced: it would load as an empty world */
+        if (Snapshot_save(snapshot_temp, &snapshot, World_current(w)) == EXIT_FAILURE) {
+
+            cJSON_Delete(root);
+
+            return EXIT_FAILURE;
+        }
+
+        data = (data = cJSON_CreateString((strrchr(path, '/') != NULL) ? strrchr(path, '/') + 1 : path)) ? data : NULL;
+        cJSON_AddItemToObject(root, "snapshot", data);
     }
 
-    for (i = 0; i < sizeof(w->text_color) / (sizeof(w->text_color[0])); i++) {
+    /* ================================ */
 
-        data = (data = cJSON_CreateNumber(w->text_color[i])) ? data : NULL;
-        cJSON_AddItemToArray(array, data);
+    snprintf(temp, sizeof(temp), "%s" SNAPSHOT_TEMP, filename);
+
+    if (((settings = cJSON_Print(root)) == NULL) || ((file = file_create(temp)) == NULL)) {
+        status = EXIT_FAILURE;
     }
+    else {
 
-    cJSON_AddItemToObject(root, "text_color", array);
+        if ((fputs(settings, file) == EOF) || (fflush(file) != 0) || (fsync(fileno(file)) != 0)) {
+            status = EXIT_FAILURE;
+        }
 
-    save_2D_array(root, "current", w->current, w->rows, w->columns);
+        if (fclose(file) != 0) {
+            status = EXIT_FAILURE;
+        }
+    }
 
-    /* ================================ */
+    /* Only complete files replace the old pair, the snapshot (which a mapped grid may still hold open) first */
+    if ((status == EXIT_FAILURE) || ((snapshot_temp[0] != '\0') && (rename(snapshot_temp, path) != 0)) || (rename(temp, filename) != 0)) {
+
+        remove(temp);
 
-    fprintf(file, "%s", cJSON_Print(root));
+        if (snapshot_temp[0] != '\0') {
+            remove(snapshot_temp);
+        }
+
+        status = EXIT_FAILURE;
+    }
 
+    cJSON_free(settings);
     cJSON_Delete(root);
-    fclose(file);
 
-    return EXIT_SUCCESS;
+    return status;
 }
 
 /* ================================================================ */
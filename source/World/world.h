@@ -5,6 +5,17 @@
 
 /* ================================================================ */
 
+#define ENGINE_GRID 1           /* Evolve the generation grids tile by tile */
+#define ENGINE_HASHLIFE 2       /* Evolve a hashed quadtree of an unbounded plane, 2^step generations at a time */
+#define ENGINE_SPARSE 3         /* Evolve the occupied chunks of an unbounded plane */
+
+#define RENDER_TEXTURE 0        /* Draw the cells through a streaming texture, a pixel per cell */
+#define RENDER_RECTS 1          /* Draw runs of live cells as rectangles, in a single call */
+#define RENDER_CELLS 2          /* Draw a rectangle per live cell, a call each */
+#define RENDERERS 3
+
+/* ================================================================ */
+
 struct world {
 
     size_t cell_size;
@@ -24,13 +35,65 @@ struct world {
 
     size_t generation;  /* Current generation */
 
-    int type;           /* How to treat the world edges. 1 - wrap the edges; 2 - what's beyond the edges is always dead; 3 - what's beyond the edges is always alive */
+    int type;           /* How to treat the world edges. 1 (`GRID_TORUS`) - wrap the edges; 2 (`GRID_DEAD`) - what's beyond the edges is always dead; 3 (`GRID_ALIVE`) - what's beyond the edges is always alive */
+
+    Rule rule;          /* Rule evolving the world: life-like, Generations or Larger than Life */
 
-    unsigned char** previous;    /* A two-dimensional array of previous generation */
-    unsigned char** current;     /* A two-dimensional array of current generation */
+    int storage;        /* Layout of the generation grids. `GRID_BITS` (64 cells per word) or `GRID_BYTES` (a byte per cell) */
+
+    int map;            /* Save snapshots through a mapped file, in a layout that loading maps straight into the current grid instead of reading it */
+
+    Grid_t generations[2];  /* Two generation grids. `generations[parity]` holds the current generation, the other one the previous */
+
+    int parity;             /* Index of the current generation grid. Flipped by every evolution step instead of copying cells */
 
     Timer_t clock;      /* A clock controlling the speed of generations */
 
+    int threads;        /* Number of threads evolving the world. 0 - one per online CPU */
+
+    Pool_t pool;        /* Workers evolving tiles. Created on the first evolution step. Not stored in the file */
+
+    Kernel_t kernel;    /* Kernel used by the current evolution step. Not stored in the file */
+
+    Tiles_t tiles;      /* Tiles of the world and which of them changed during the last generation. Not stored in the file */
+
+    Sched_t sched;      /* Tile scheduler. Created on the first evolution step. Not stored in the file */
+
+    int engine;         /* How the world is evolved. `ENGINE_GRID` or `ENGINE_HASHLIFE` */
+
+    unsigned step;      /* With `ENGINE_HASHLIFE`, an evolution step advances 2^step generations */
+
+    size_t memory;      /* With `ENGINE_HASHLIFE`, MiB of nodes above which unused ones are collected. 0 - no limit */
+
+    Quad_t quad;        /* With `ENGINE_HASHLIFE`, the plane holding the world. The part covered by the window is copied into the current grid after every step.
+                         * Cells leaving the window keep living outside of it, so `type` does not apply. Created on the first evolution step. Not stored in the file */
+
+    Sparse_t sparse;    /* With `ENGINE_SPARSE`, the plane holding the world, copied into the current grid the same way. Created on the first evolution step. Not stored in the file */
+
+    int64_t top;        /* With `ENGINE_SPARSE`, the cell of the plane shown in the top left corner of the window. Not stored in the file */
+    int64_t left;
+
+    Record_t record;    /* Log of the generations, or NULL if they are not recorded. Set up from the command line. Not stored in the file */
+
+    int renderer;       /* How the cells are drawn. `RENDER_TEXTURE`, `RENDER_RECTS` or `RENDER_CELLS`. Switched with R during a run */
+
+    View_t view;        /* With `RENDER_TEXTURE`, the texture the cells are drawn through. Created by the first presentation of a run. Not stored in the file */
+
+    Triple_t handoff;   /* While a run evolves the world on its own thread, the generations handed over to the window. Not stored in the file */
+
+    size_t shown;       /* Generation drawn by the last presentation. Not stored in the file */
+
+    Overlay_t overlay;  /* Grid lines, drawn once and copied onto every frame. Created by the first presentation of a run. Not stored in the file */
+
+    SDL_Rect* rects;    /* With `RENDER_RECTS`, the rectangles of a frame. Grows as needed and is kept between frames. Not stored in the file */
+    size_t capacity;
+
+    size_t frames[RENDERERS];   /* Number of frames drawn by every renderer. Not stored in the file */
+    size_t draws[RENDERERS];    /* Number of renderer calls they took */
+    double drawing[RENDERERS];  /* Seconds they took */
+
+    Autosave_t autosave;    /* Periodic saves written in the background, or NULL if there are none. Set up from the command line. Not stored in the file */
+
     float rate;
 
     float percent;      /* How many cells to initialize at the start (%) */
@@ -40,6 +103,20 @@ typedef struct world World;
 
 typedef World* World_t;
 
+/* ================================================================ */
+
+/**
+ * Get the grid holding the current generation of the world.
+*/
+#define World_current(w) ((w)->generations[(w)->parity])
+
+/* ================================ */
+
+/**
+ * Get the grid holding the previous generation of the world. The next evolution step overwrites it.
+*/
+#define World_previous(w) ((w)->generations[!(w)->parity])
+
 /* ================================================================ */
 /* ========================== INTERFACE =========================== */
 /* ================================================================ */
@@ -51,6 +128,13 @@ extern void World_run(const World_t world);
 
 /* ================================ */
 
+/**
+ * Evolve the world by `generations` generations as fast as possible, without a window, and print the throughput.
+*/
+extern void World_run_headless(const World_t world, size_t generations);
+
+/* ================================ */
+
 /**
  * Dynamically allocate a new instance of a world of `World_t` type.
  * The function opens a file called `default.json`, which governs the initials of the world, and initializes the world.
@@ -67,6 +151,13 @@ extern int World_save(const char* filename, const World_t w);
 
 /* ================================ */
 
+/**
+ * Save the world into `filename` every `every` generations or, if `seconds` is set, seconds, without waiting for the disk.
+*/
+extern int World_autosave(const World_t w, const char* filename, size_t every, int seconds);
+
+/* ================================ */
+
 extern int World_destroy(World_t* w);
 
 /* ================================ */
@@ -83,6 +174,13 @@ extern void World_present(const World_t world, const Window_t w);
 
 /* ================================ */
 
+/**
+ * Draw the grid lines over the cells.
+*/
+extern void World_present_grid(const World_t world, const Window_t w);
+
+/* ================================ */
+
 extern void World_randomize(const World_t w, int c);
 
 /* ================================ */
@@ -91,6 +189,28 @@ extern void World_evolve(const World_t w);
 
 /* ================================ */
 
+/**
+ * Add the live cells of an RLE, Life 1.06 or plaintext pattern file to the current generation, its top left corner at (`top`, `left`).
+ * The world keeps its rule: a warning is printed when the header of an RLE pattern names another one.
+*/
+extern int World_import(const World_t w, const char* filename, int64_t top, int64_t left);
+
+/* ================================ */
+
+/**
+ * Write the live cells of the current generation into an RLE, Life 1.06 or plaintext pattern file, picked by the extension of `filename`.
+*/
+extern int World_export(const World_t w, const char* filename);
+
+/* ================================ */
+
+/**
+ * Move the window of a sparse world by `rows` and `columns` cells over the plane.
+*/
+extern void World_pan(const World_t w, int64_t rows, int64_t columns);
+
+/* ================================ */
+
 extern void World_edit(const World_t world);
 
 /* ================================================================ */
@@ -0,0 +1,372 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+static double _Autosave_now(void) {
+
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/* ================================ */
+
+/**
+ * Flush the file or directory `path` to the disk.
+*/
+static int _Autosave_sync(const char* path) {
+
+    int fd = 0;
+    int status = EXIT_SUCCESS;
+
+    if ((fd = open(path, O_RDONLY)) < 0) {
+        return EXIT_FAILURE;
+    }
+
+    if (fsync(fd) != 0) {
+        status = EXIT_FAILURE;
+    }
+
+    close(fd);
+
+    return status;
+}
+
+/* ================================ */
+
+/**
+ * Replace `path` with the synced file `path` + `AUTOSAVE_TEMP`, so a crash leaves either the old file or the new one.
+*/
+static int _Autosave_replace(const char* path) {
+
+    char temp[AUTOSAVE_PATH + sizeof(AUTOSAVE_TEMP)];
+
+    snprintf(temp, sizeof(temp), "%s" AUTOSAVE_TEMP, path);
+
+    if ((_Autosave_sync(temp) == EXIT_FAILURE) || (rename(temp, path) != 0)) {
+
+        remove(temp);
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Write the generation held by the writer: the snapshot first, then the world file naming it, then the directory entries.
+*/
+static int _Autosave_write(const Autosave_t a) {
+
+    char temp[AUTOSAVE_PATH + sizeof(AUTOSAVE_TEMP)];
+    char directory[AUTOSAVE_PATH];
+
+    char* slash = NULL;
+
+    FILE* file = NULL;
+
+    int status = EXIT_SUCCESS;
+
+    /* A snapshot replaces the old one by itself once synced */
+    if (Snapshot_save(a->snapshot, &a->header, a->grid) == EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    snprintf(temp, sizeof(temp), "%s" AUTOSAVE_TEMP, a->filename);
+
+    if ((file = fopen(temp, "w")) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    status = (fputs(a->settings, file) == EOF) ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    if ((fclose(file) != 0) || (status == EXIT_FAILURE)) {
+
+        remove(temp);
+
+        return EXIT_FAILURE;
+    }
+
+    if (_Autosave_replace(a->filename) == EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    /* Renames are only durable once the directory is synced */
+    strcpy(directory, a->filename);
+
+    if ((slash = strrchr(directory, '/')) != NULL) {
+        *slash = '\0';
+    }
+    else {
+        strcpy(directory, ".");
+    }
+
+    return _Autosave_sync(directory);
+}
+
+/* ================================ */
+
+static void* _Autosave_main(void* arg) {
+
+    Autosave_t a = (Autosave_t) arg;
+
+    double start = 0;
+    int status = EXIT_SUCCESS;
+
+    while (1) {
+
+        pthread_mutex_lock(&a->lock);
+
+        while ((a->grid == NULL) && !a->quit) {
+            pthread_cond_wait(&a->wake, &a->lock);
+        }
+
+        if (a->grid == NULL) {
+
+            pthread_mutex_unlock(&a->lock);
+
+            break ;
+        }
+
+        pthread_mutex_unlock(&a->lock);
+
+        start = _Autosave_now();
+
+        status = _Autosave_write(a);
+
+        pthread_mutex_lock(&a->lock);
+
+        a->busy += _Autosave_now() - start;
+
+        if (status == EXIT_SUCCESS) {
+            a->saves++;
+        }
+        else {
+            a->failures++;
+        }
+
+        cJSON_free(a->settings);
+        a->settings = NULL;
+
+        /* The saved grid becomes the spare one */
+        Grid_destroy(&a->spare);
+
+        a->spare = a->grid;
+        a->grid = NULL;
+
+        pthread_cond_broadcast(&a->wake);
+        pthread_mutex_unlock(&a->lock);
+    }
+
+    return NULL;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+Autosave_t Autosave_new(const char* filename, const char* snapshot, size_t generation, size_t every, int seconds) {
+
+    Autosave_t a = NULL;
+
+    if ((filename == NULL) || (snapshot == NULL) || (strlen(filename) >= AUTOSAVE_PATH) || (strlen(snapshot) >= AUTOSAVE_PATH)) {
+        return NULL;
+    }
+
+    if ((a = (Autosave_t) calloc(1, sizeof(struct autosave))) == NULL) {
+        return NULL;
+    }
+
+    strcpy(a->filename, filename);
+    strcpy(a->snapshot, snapshot);
+
+    a->every = (every > 0) ? every : 1;
+    a->seconds = seconds;
+
+    a->next = generation + a->every;
+    a->deadline = _Autosave_now() + (double) a->every;
+
+    pthread_mutex_init(&a->lock, NULL);
+    pthread_cond_init(&a->wake, NULL);
+
+    if (pthread_create(&a->thread, NULL, _Autosave_main, a) != 0) {
+
+        pthread_mutex_destroy(&a->lock);
+        pthread_cond_destroy(&a->wake);
+
+        free(a);
+
+        return NULL;
+    }
+
+    return a;
+}
+
+/* ================================================================ */
+
+int Autosave_due(Autosave_t a, size_t generation) {
+
+    int busy = 0;
+
+    if ((a == NULL) || (a->seconds ? (_Autosave_now() < a->deadline) : (generation < a->next))) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&a->lock);
+
+    if ((busy = (a->grid != NULL))) {
+        a->delayed++;
+    }
+
+    pthread_mutex_unlock(&a->lock);
+
+    return !busy;
+}
+
+/* ================================================================ */
+
+int Autosave_take(Autosave_t a, Grid_t* g, int copy, const Snapshot* s, char* settings) {
+
+    Grid_t spare = NULL;
+    Grid_t temp = NULL;
+
+    if ((a == NULL) || (g == NULL) || (*g == NULL) || (s == NULL) || (settings == NULL)) {
+
+        cJSON_free(settings);
+
+        return EXIT_FAILURE;
+    }
+
+    pthread_mutex_lock(&a->lock);
+
+    if (a->grid != NULL) {
+
+        pthread_mutex_unlock(&a->lock);
+
+        cJSON_free(settings);
+
+        return EXIT_FAILURE;
+    }
+
+    /* The writer is idle, so the spare grid is not touched by it */
+    spare = a->spare;
+    a->spare = NULL;
+
+    pthread_mutex_unlock(&a->lock);
+
+    if ((spare == NULL) || (spare->rows != (*g)->rows) || (spare->columns != (*g)->columns) || (spare->format != (*g)->format)) {
+
+        Grid_destroy(&spare);
+
+        if ((spare = Grid_new((*g)->rows, (*g)->columns, (*g)->format)) == NULL) {
+
+            cJSON_free(settings);
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (copy) {
+        memcpy(spare->cells, (*g)->cells, (*g)->rows * (*g)->words * sizeof(uint64_t));
+    }
+    else {
+
+        temp = *g;
+
+        *g = spare;
+        spare = temp;
+    }
+
+    pthread_mutex_lock(&a->lock);
+
+    a->grid = spare;
+    a->header = *s;
+    a->settings = settings;
+
+    pthread_cond_broadcast(&a->wake);
+    pthread_mutex_unlock(&a->lock);
+
+    if (a->seconds) {
+        a->deadline = _Autosave_now() + (double) a->every;
+    }
+    else {
+        a->next = s->generation + a->every;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+void Autosave_wait(Autosave_t a) {
+
+    if (a == NULL) {
+        return ;
+    }
+
+    pthread_mutex_lock(&a->lock);
+
+    while (a->grid != NULL) {
+        pthread_cond_wait(&a->wake, &a->lock);
+    }
+
+    pthread_mutex_unlock(&a->lock);
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Autosave_log(const Autosave_t a) {
+
+    if (a == NULL) {
+        return ;
+    }
+
+    pthread_mutex_lock(&a->lock);
+
+    printf("%-16s: %ld (%.3f s writing)\n", "autosaves", a->saves, a->busy);
+    printf("%-16s: %ld failed, %ld delayed\n", "not autosaved", a->failures, a->delayed);
+
+    pthread_mutex_unlock(&a->lock);
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Autosave_destroy(Autosave_t* a) {
+
+    if ((a == NULL) || (*a == NULL)) {
+        return ;
+    }
+
+    pthread_mutex_lock(&(*a)->lock);
+
+    (*a)->quit = 1;
+
+    pthread_cond_broadcast(&(*a)->wake);
+    pthread_mutex_unlock(&(*a)->lock);
+
+    /* The writer finishes the save in flight before it leaves */
+    pthread_join((*a)->thread, NULL);
+
+    pthread_mutex_destroy(&(*a)->lock);
+    pthread_cond_destroy(&(*a)->wake);
+
+    Grid_destroy(&(*a)->spare);
+
+    free(*a);
+
+    *a = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
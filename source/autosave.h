@@ -0,0 +1,98 @@
+#ifndef GOL_AUTOSAVE_H
+#define GOL_AUTOSAVE_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define AUTOSAVE_PATH 256       /* Maximum path size */
+#define AUTOSAVE_TEMP ".tmp"    /* Suffix of a file being written. It replaces the saved one once synced */
+
+/* ================================================================ */
+
+/**
+ * Periodic saves of a world, written by a background thread.
+ * The world hands over a grid holding the generation to save and gets a spare one back, so it never waits for the disk.
+ * At most one save is in flight: a save falling due while the previous one is being written waits for it to finish.
+*/
+struct autosave {
+
+    char filename[AUTOSAVE_PATH];   /* World file */
+    char snapshot[AUTOSAVE_PATH];   /* Snapshot named by the world file */
+
+    size_t every;               /* Save every `every` generations, or seconds */
+    int seconds;                /* Whether `every` counts seconds */
+
+    size_t next;                /* Generation from which the next save is due */
+    double deadline;            /* Time from which the next save is due */
+
+    Grid_t spare;               /* Grid given to the world in exchange for the next one saved */
+
+    Grid_t grid;                /* Generation being saved. Owned by the writer while not NULL */
+    Snapshot header;            /* Its snapshot header */
+    char* settings;             /* Text of the world file naming the snapshot */
+
+    size_t saves;               /* Number of saves written */
+    size_t failures;            /* Number of saves not written */
+    size_t delayed;             /* Number of times a save was due while the previous one was being written */
+    double busy;                /* Seconds spent writing */
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        /* Broadcast when a generation is handed over, a save is written or the writer is stopped */
+
+    int quit;
+};
+
+typedef struct autosave Autosave;
+
+typedef Autosave* Autosave_t;
+
+/* ================================================================ */
+
+/**
+ * Start saving a world at generation `generation` into `filename`, with its cells in the snapshot `snapshot`,
+ * every `every` generations or, if `seconds` is set, seconds.
+*/
+extern Autosave_t Autosave_new(const char* filename, const char* snapshot, size_t generation, size_t every, int seconds);
+
+/* ================================================================ */
+
+/**
+ * Check whether a save is due at generation `generation` and the writer is free to take it.
+*/
+extern int Autosave_due(Autosave_t a, size_t generation);
+
+/* ================================================================ */
+
+/**
+ * Hand the generation held by `*g` over to the writer, together with its snapshot header `s` and the text of the world file `settings`,
+ * which is freed with `cJSON_free` once written. `*g` is replaced by a spare grid of the same size whose cells are left as they are.
+ * If `copy` is set, the cells of `*g` are copied into the spare grid, which is handed over instead, and `*g` is kept.
+*/
+extern int Autosave_take(Autosave_t a, Grid_t* g, int copy, const Snapshot* s, char* settings);
+
+/* ================================================================ */
+
+/**
+ * Wait for the save in flight, if any, to be written.
+*/
+extern void Autosave_wait(Autosave_t a);
+
+/* ================================================================ */
+
+/**
+ * Print how many saves were written.
+*/
+extern void Autosave_log(const Autosave_t a);
+
+/* ================================================================ */
+
+/**
+ * Wait for the save in flight, stop the writer, deallocate the autosave and set the pointer to NULL.
+*/
+extern void Autosave_destroy(Autosave_t* a);
+
+/* ================================================================ */
+
+#endif /* GOL_AUTOSAVE_H */
@@ -0,0 +1,290 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/* Number of words per cache line */
+#define LINE (GRID_ALIGN / sizeof(uint64_t))
+
+/* ================================ */
+
+/**
+ * Mask of the valid bits in the last used word of a row.
+*/
+static uint64_t _Grid_tail(const Grid_t g) {
+    return (g->columns % GRID_WORD) ? (UINT64_C(1) << (g->columns % GRID_WORD)) - 1 : ~UINT64_C(0);
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+Grid_t Grid_new(size_t rows, size_t columns, int format) {
+
+    Grid_t g = NULL;
+
+    /* Number of words used by a row */
+    size_t used = 0;
+
+    /* Total size of the cell block in bytes */
+    size_t size = 0;
+
+    if ((g = (Grid_t) calloc(1, sizeof(struct grid))) == NULL) {
+        return NULL;
+    }
+
+    g->rows = rows;
+    g->columns = columns;
+    g->format = (format == GRID_BYTES) ? GRID_BYTES : GRID_BITS;
+
+    used = (g->format == GRID_BYTES) ? (columns + sizeof(uint64_t) - 1) / sizeof(uint64_t) : (columns + GRID_WORD - 1) / GRID_WORD;
+
+    /* Pad every row up to a whole cache line, so rows never share a line */
+    g->words = ((used + LINE - 1) / LINE) * LINE;
+
+    /* Prevent overflow */
+    if ((g->words != 0) && (rows > SIZE_MAX / sizeof(uint64_t) / g->words)) {
+
+        free(g);
+
+        return NULL;
+    }
+
+    size = rows * g->words * sizeof(uint64_t);
+
+    /* An empty world still gets a valid (one line) block */
+    if ((g->cells = (uint64_t*) aligned_alloc(GRID_ALIGN, size ? size : GRID_ALIGN)) == NULL) {
+
+        free(g);
+
+        return NULL;
+    }
+
+    memset(g->cells, 0, size);
+
+    return g;
+}
+
+/* ================================================================ */
+
+void Grid_destroy(Grid_t* g) {
+
+    if ((g == NULL) || (*g == NULL)) {
+        return ;
+    }
+
+    if ((*g)->mapping != NULL) {
+        munmap((*g)->mapping, (*g)->mapped);
+    }
+    else {
+        free((*g)->cells);
+    }
+
+    free((*g)->halo);
+
+    free(*g);
+
+    *g = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
+
+int Grid_halo(Grid_t g, int edge) {
+
+    if (g == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    if ((edge != GRID_DEAD) && (edge != GRID_ALIVE)) {
+
+        free(g->halo);
+
+        g->halo = NULL;
+        g->edge = GRID_TORUS;
+
+        return EXIT_SUCCESS;
+    }
+
+    /* Filled once: the halo never changes while the mode stays the same */
+    if ((g->halo != NULL) && (g->edge == edge)) {
+        return EXIT_SUCCESS;
+    }
+
+    if ((g->halo == NULL) && ((g->halo = (uint64_t*) aligned_alloc(GRID_ALIGN, (g->words ? g->words : LINE) * sizeof(uint64_t))) == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    /* Live bytes hold 1, live bits fill whole words */
+    memset(g->halo, (edge == GRID_DEAD) ? 0x00 : (g->format == GRID_BYTES) ? 0x01 : 0xFF, (g->words ? g->words : LINE) * sizeof(uint64_t));
+
+    g->edge = edge;
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+void Grid_clear(Grid_t g, unsigned char v) {
+
+    size_t row = 0;
+
+    size_t word = 0;
+    size_t used = 0;
+
+    uint64_t* r = NULL;
+
+    if (g == NULL) {
+        return ;
+    }
+
+    if (v == 0) {
+
+        memset(g->cells, 0, g->rows * g->words * sizeof(uint64_t));
+
+        return ;
+    }
+
+    if (g->format == GRID_BYTES) {
+
+        for (row = 0; row < g->rows; row++) {
+            memset(Grid_bytes(g, row), v, g->columns);
+        }
+
+        return ;
+    }
+
+    used = (g->columns + GRID_WORD - 1) / GRID_WORD;
+
+    for (row = 0; row < g->rows; row++) {
+
+        r = Grid_row(g, row);
+
+        for (word = 0; word < used; word++) {
+            r[word] = ~UINT64_C(0);
+        }
+
+        /* Keep the padding dead */
+        if (used > 0) {
+            r[used - 1] &= _Grid_tail(g);
+        }
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+
+int Grid_equal(const Grid_t g_1, const Grid_t g_2, size_t top, size_t bottom, size_t left, size_t right) {
+
+    size_t row = 0;
+
+    /* Part of a row to compare, in bytes */
+    size_t offset = 0;
+    size_t size = 0;
+
+    if (left >= right) {
+        return 1;
+    }
+
+    if (g_1->format == GRID_BYTES) {
+
+        offset = left;
+        size = right - left;
+    }
+    else {
+
+        /* Padding bits are always 0, so whole words can be compared */
+        offset = (left / GRID_WORD) * sizeof(uint64_t);
+        size = ((right + GRID_WORD - 1) / GRID_WORD) * sizeof(uint64_t) - offset;
+    }
+
+    for (row = top; row < bottom; row++) {
+
+        if (memcmp((unsigned char*) Grid_row(g_1, row) + offset, (unsigned char*) Grid_row(g_2, row) + offset, size) != 0) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* ================================================================ */
+
+uint64_t Grid_word(const Grid_t g, size_t row, size_t word) {
+
+    const unsigned char* bytes = NULL;
+
+    uint64_t w = 0;
+
+    size_t i = 0;
+
+    if (g->format == GRID_BITS) {
+        return Grid_row(g, row)[word];
+    }
+
+    bytes = Grid_bytes(g, row) + word * GRID_WORD;
+
+    for (i = 0; (i < GRID_WORD) && (word * GRID_WORD + i < g->columns); i++) {
+        w |= (uint64_t) (bytes[i] == 1) << i;
+    }
+
+    return w;
+}
+
+/* ================================================================ */
+
+int Grid_load(const cJSON* root, const char* name, Grid_t g) {
+
+    size_t row = 0;
+    size_t column = 0;
+
+    /* Array extracted from the root */
+    cJSON* array = NULL;
+
+    cJSON* element = NULL;
+
+    cJSON* r = NULL;
+
+    if (g == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    /* Retreiving an array from a .json file */
+    if ((array = (cJSON*) Data_read(name == NULL ? "array" : name, root, cJSON_IsArray)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    /* Rows and cells are walked in order through their links: looking every one of them up by index would cost a walk from the head each */
+    cJSON_ArrayForEach(r, array) {
+
+        /* A file may describe a bigger world than the grid ... */
+        if (row >= g->rows) {
+            break ;
+        }
+
+        column = 0;
+
+        cJSON_ArrayForEach(element, r) {
+
+            if (column >= g->columns) {
+                break ;
+            }
+
+            /* ... or a smaller one */
+            Grid_set(g, row, column, element->valueint);
+
+            column++;
+        }
+
+        row++;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+#undef LINE
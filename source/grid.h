@@ -0,0 +1,159 @@
+#ifndef GOL_GRID_H
+#define GOL_GRID_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define GRID_ALIGN 64           /* Cache line size. Every row starts on its own line */
+#define GRID_WORD 64            /* Number of cells packed into a single word */
+
+#define GRID_BITS 1             /* One bit per cell, 64 cells per word */
+#define GRID_BYTES 2            /* One byte per cell */
+
+#define GRID_TORUS 1            /* Beyond an edge lies the opposite edge */
+#define GRID_DEAD 2             /* Beyond the edges, every cell is dead */
+#define GRID_ALIVE 3            /* Beyond the edges, every cell is alive */
+
+/* ================================================================ */
+
+struct grid {
+
+    size_t rows;        /* Number of rows */
+    size_t columns;     /* Number of columns */
+
+    int format;         /* Cell layout. Either `GRID_BITS` or `GRID_BYTES` */
+
+    size_t words;       /* Number of words in a row, padded to a whole cache line. Padding cells are always 0 */
+
+    uint64_t* cells;    /* A single cache-line-aligned block of `rows * words` words. With `GRID_BITS`, bit `c % 64` of word `c / 64` is the cell in column `c`; with `GRID_BYTES`, byte `c` of the row is */
+
+    void* mapping;      /* Mapped file holding the cells, or NULL if they were allocated */
+    size_t mapped;      /* Size of the mapping */
+
+    int edge;           /* What lies beyond the edges. `GRID_TORUS` (or 0), `GRID_DEAD` or `GRID_ALIVE`. Set with `Grid_halo` */
+    uint64_t* halo;     /* With `GRID_DEAD` or `GRID_ALIVE`, a row of `words` words of the cells beyond the top and the bottom edges. NULL for a torus */
+};
+
+typedef struct grid Grid;
+
+typedef Grid* Grid_t;
+
+/* ================================================================ */
+
+/**
+ * Get a pointer to the first word of the row `row`.
+*/
+#define Grid_row(g, row) ((g)->cells + (size_t) (row) * (g)->words)
+
+/* ================================ */
+
+/**
+ * Get a pointer to the first cell of the row `row` of a `GRID_BYTES` grid.
+*/
+#define Grid_bytes(g, row) ((unsigned char*) Grid_row(g, row))
+
+/* ================================ */
+
+/**
+ * Get a pointer to the first word of the row above (`Grid_above`) or below (`Grid_below`) the row `row`.
+ * Beyond the top and the bottom edges lies the opposite edge of a torus, or the halo of a bounded grid.
+*/
+#define Grid_above(g, row) (((row) > 0) ? Grid_row(g, (row) - 1) : ((g)->halo == NULL) ? Grid_row(g, (g)->rows - 1) : (g)->halo)
+
+#define Grid_below(g, row) (((size_t) (row) + 1 < (g)->rows) ? Grid_row(g, (row) + 1) : ((g)->halo == NULL) ? Grid_row(g, 0) : (g)->halo)
+
+/* ================================ */
+
+/**
+ * Get the value of the cells beyond the left and the right edges of a bounded grid.
+*/
+#define Grid_beyond(g) ((unsigned char) ((g)->edge == GRID_ALIVE))
+
+/* ================================ */
+
+/**
+ * Get the value of the cell at (`row`, `column`).
+*/
+#define Grid_get(g, row, column) \
+    ((g)->format == GRID_BYTES \
+        ? Grid_bytes(g, row)[column] \
+        : (unsigned char) ((Grid_row(g, row)[(size_t) (column) / GRID_WORD] >> ((size_t) (column) % GRID_WORD)) & 1))
+
+/* ================================ */
+
+/**
+ * Set the cell at (`row`, `column`) to `v`. A bit-packed grid stores 1 for any non-zero `v`.
+*/
+#define Grid_set(g, row, column, v) \
+    ((g)->format == GRID_BYTES \
+        ? (void) (Grid_bytes(g, row)[column] = (unsigned char) (v)) \
+        : (void) (Grid_row(g, row)[(size_t) (column) / GRID_WORD] = (Grid_row(g, row)[(size_t) (column) / GRID_WORD] & ~(UINT64_C(1) << ((size_t) (column) % GRID_WORD))) | ((uint64_t) ((v) != 0) << ((size_t) (column) % GRID_WORD))))
+
+/* ================================ */
+
+/**
+ * Flip the cell at (`row`, `column`) between 0 and 1.
+*/
+#define Grid_toggle(g, row, column) \
+    ((g)->format == GRID_BYTES \
+        ? (void) (Grid_bytes(g, row)[column] = !Grid_bytes(g, row)[column]) \
+        : (void) (Grid_row(g, row)[(size_t) (column) / GRID_WORD] ^= UINT64_C(1) << ((size_t) (column) % GRID_WORD)))
+
+/* ================================================================ */
+
+/**
+ * Dynamically allocate a grid of size rows * columns in the layout `format` with every cell set to 0.
+ * The whole grid is a single allocation.
+*/
+extern Grid_t Grid_new(size_t rows, size_t columns, int format);
+
+/* ================================================================ */
+
+/**
+ * Deallocate a grid and set the pointer to NULL. A grid mapped from a file is unmapped.
+*/
+extern void Grid_destroy(Grid_t* g);
+
+/* ================================================================ */
+
+/**
+ * Set what lies beyond the edges of the grid. `GRID_DEAD` and `GRID_ALIVE` fill a halo row once; anything else makes the grid a torus.
+ * Kernels read the rows above and below through the halo, so every edge mode is evolved by the same loops.
+*/
+extern int Grid_halo(Grid_t g, int edge);
+
+/* ================================================================ */
+
+/**
+ * Set every cell of the grid to `v`. Padding cells are left untouched.
+*/
+extern void Grid_clear(Grid_t g, unsigned char v);
+
+/* ================================================================ */
+
+/**
+ * Check whether two grids of the same size hold the same cells in the rows `top` .. `bottom - 1` and the columns `left` .. `right - 1`.
+ * With a bit-packed grid, `left` must be a multiple of 64.
+*/
+extern int Grid_equal(const Grid_t g_1, const Grid_t g_2, size_t top, size_t bottom, size_t left, size_t right);
+
+/* ================================================================ */
+
+/**
+ * Get the cells of the columns `64 * word` .. `64 * word + 63` of a row as a bit-packed word, whatever the layout of the grid.
+ * Only cells in state 1 are alive: decaying cells of a byte grid are dead in the word.
+*/
+extern uint64_t Grid_word(const Grid_t g, size_t row, size_t word);
+
+/* ================================================================ */
+
+/**
+ * Load a grid from a JSON structure. The parsed JSON object must contain an array of rows called `name`.
+ * Only used for files written before snapshots.
+*/
+extern int Grid_load(const cJSON* root, const char* name, Grid_t g);
+
+/* ================================================================ */
+
+#endif /* GOL_GRID_H */
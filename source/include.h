@@ -4,12 +4,36 @@
 /* ================================================================ */
 
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <dirent.h>
 #include <unistd.h>
 #include <getopt.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
 #include "../../LilEn/LilEn.h"
 
-#include "array.h"
+#include "grid.h"
+#include "rule.h"
+#include "kernel.h"
+#include "simd.h"
+#include "pool.h"
+#include "tiles.h"
+#include "sched.h"
+#include "quad.h"
+#include "sparse.h"
+#include "snapshot.h"
+#include "record.h"
+#include "autosave.h"
+#include "pattern.h"
+#include "view.h"
+#include "overlay.h"
+#include "triple.h"
+#include "verify.h"
 #include "file.h"
 #include "World/world.h"
 
@@ -0,0 +1,595 @@
+#include "include.h"
+
+/* Size of a summed-area table of `Kernel_larger`: a tile and the largest range around it, after a row and a column of zeros */
+#define SUMS_HEIGHT (TILE_ROWS + 2 * RULE_RANGE + 1)
+#define SUMS_WIDTH (TILE_COLUMNS + 2 * RULE_RANGE + 1)
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/* Summed-area table of every thread running `Kernel_larger`, freed when the thread exits */
+static pthread_key_t _Kernel_key;
+static pthread_once_t _Kernel_once = PTHREAD_ONCE_INIT;
+static int _Kernel_keyed = 0;
+
+/* ================================ */
+
+/**
+ * Compute the words `first` .. `last - 1` of the next generation of the row `mid` with the rows `up` and `down` around it.
+ * A row holds `used` words, and `tail` is the position of the last column in the last of them.
+ * Across the left and the right edges lies the opposite column if `torus` is set, the cells `beyond` otherwise.
+ * Always inlined, so that a kernel passing constant masks gets a loop specialized for its rule.
+*/
+__attribute__((always_inline))
+static inline void _Kernel_bits_row(uint64_t* out, const uint64_t* up, const uint64_t* mid, const uint64_t* down, size_t first, size_t last, size_t used, size_t tail, int torus, uint64_t beyond, unsigned born, unsigned survives) {
+
+    size_t i = 0;
+
+    /* Neighbours to the west (l) and to the east (r) of every cell of the three rows */
+    uint64_t ul, ur, ml, mr, dl, dr;
+
+    /* Cells coming from across the edges */
+    uint64_t u_in, m_in, d_in;
+
+    for (i = first; i < last; i++) {
+
+        /* West: cell c - 1 moves to c. The first word receives the last column, or what lies beyond */
+        u_in = (i == 0) ? (torus ? (up[used - 1] >> tail) & 1 : beyond) : up[i - 1] >> (GRID_WORD - 1);
+        m_in = (i == 0) ? (torus ? (mid[used - 1] >> tail) & 1 : beyond) : mid[i - 1] >> (GRID_WORD - 1);
+        d_in = (i == 0) ? (torus ? (down[used - 1] >> tail) & 1 : beyond) : down[i - 1] >> (GRID_WORD - 1);
+
+        ul = (up[i] << 1) | u_in;
+        ml = (mid[i] << 1) | m_in;
+        dl = (down[i] << 1) | d_in;
+
+        /* East: cell c + 1 moves to c. The last column receives the first one, or what lies beyond */
+        ur = (up[i] >> 1) | ((i + 1 == used) ? (torus ? up[0] & 1 : beyond) << tail : up[i + 1] << (GRID_WORD - 1));
+        mr = (mid[i] >> 1) | ((i + 1 == used) ? (torus ? mid[0] & 1 : beyond) << tail : mid[i + 1] << (GRID_WORD - 1));
+        dr = (down[i] >> 1) | ((i + 1 == used) ? (torus ? down[0] & 1 : beyond) << tail : down[i + 1] << (GRID_WORD - 1));
+
+        out[i] = Kernel_rule(ul, up[i], ur, ml, mid[i], mr, dl, down[i], dr, born, survives);
+    }
+
+    /* Keep the padding dead */
+    if ((first < last) && (last == used)) {
+        out[used - 1] &= (tail + 1 < GRID_WORD) ? (UINT64_C(1) << (tail + 1)) - 1 : ~UINT64_C(0);
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Check whether the cell at (`row`, `column`) is alive. Either may lie beyond an edge, by as much as the range of a rule.
+ * Reads the edge mode itself rather than the halo, so the reference kernel stays independent of it.
+*/
+static unsigned char _Kernel_cell(const Grid_t g, int row, int column) {
+
+    const int rows = (int) g->rows;
+    const int columns = (int) g->columns;
+
+    if ((row < 0) || (row >= rows) || (column < 0) || (column >= columns)) {
+
+        if ((g->edge == GRID_DEAD) || (g->edge == GRID_ALIVE)) {
+            return g->edge == GRID_ALIVE;
+        }
+
+        row = (row % rows + rows) % rows;
+        column = (column % columns + columns) % columns;
+    }
+
+    /* Decaying cells are not alive */
+    return Grid_get(g, row, column) == 1;
+}
+
+/* ================================ */
+
+/**
+ * Compute the next state of the byte cell in the column `column` of the row `mid` under a Generations rule,
+ * with the left and the right edges given by the edge mode of `g`.
+*/
+static unsigned char _Kernel_generations_edge(const Grid_t g, const Rule* rule, const unsigned char* up, const unsigned char* mid, const unsigned char* down, size_t column) {
+
+    /* What the three cells of a column beyond the left or the right edge add */
+    const unsigned beyond = 3u * Grid_beyond(g);
+    const int torus = (g->halo == NULL);
+
+    size_t west = (column > 0) ? column - 1 : g->columns - 1;
+    size_t east = (column + 1 < g->columns) ? column + 1 : 0;
+
+    unsigned count = (up[column] == 1) + (down[column] == 1);
+
+    count += ((column > 0) || torus) ? (unsigned) ((up[west] == 1) + (mid[west] == 1) + (down[west] == 1)) : beyond;
+    count += ((column + 1 < g->columns) || torus) ? (unsigned) ((up[east] == 1) + (mid[east] == 1) + (down[east] == 1)) : beyond;
+
+    return Rule_next(rule, mid[column], count);
+}
+
+/* ================================ */
+
+/**
+ * Evolve the rows `top` .. `bottom - 1` of a bit-packed grid under the rule of masks `born` and `survives`.
+*/
+__attribute__((always_inline))
+static inline void _Kernel_bits(Grid_t next, const Grid_t prev, size_t top, size_t bottom, size_t left, size_t right, unsigned born, unsigned survives) {
+
+    size_t row = 0;
+
+    /* Number of words actually holding cells */
+    size_t used = 0;
+
+    if ((prev->rows == 0) || (prev->columns == 0)) {
+        return ;
+    }
+
+    used = (prev->columns + GRID_WORD - 1) / GRID_WORD;
+
+    for (row = top; row < bottom; row++) {
+
+        _Kernel_bits_row(
+            Grid_row(next, row),
+            Grid_above(prev, row),
+            Grid_row(prev, row),
+            Grid_below(prev, row),
+            left / GRID_WORD,
+            (right + GRID_WORD - 1) / GRID_WORD,
+            used,
+            (prev->columns - 1) % GRID_WORD,
+            prev->halo == NULL,
+            Grid_beyond(prev),
+            born,
+            survives
+        );
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Define a bit-packed kernel specialized for the rule of masks `born` and `survives`, known at compile time.
+*/
+#define KERNEL_BITS(name, born, survives) \
+    static void name(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right) { \
+        (void) rule; \
+        _Kernel_bits(next, prev, top, bottom, left, right, born, survives); \
+    }
+
+KERNEL_BITS(_Kernel_life, KERNEL_LIFE_BORN, KERNEL_LIFE_SURVIVES)     /* B3/S23 */
+KERNEL_BITS(_Kernel_highlife, 0x048, 0x00C)                          /* B36/S23 */
+KERNEL_BITS(_Kernel_day_and_night, 0x1C8, 0x1D8)                     /* B3678/S34678 */
+KERNEL_BITS(_Kernel_seeds, 0x004, 0x000)                             /* B2/S */
+KERNEL_BITS(_Kernel_without_death, 0x008, 0x1FF)                     /* B3/S012345678 */
+KERNEL_BITS(_Kernel_morley, 0x148, 0x034)                            /* B368/S245 */
+KERNEL_BITS(_Kernel_maze, 0x008, 0x03E)                              /* B3/S12345 */
+
+#undef KERNEL_BITS
+
+/* Rules with a specialized kernel */
+static const struct {
+    unsigned born;
+    unsigned survives;
+    Kernel_t kernel;
+} KERNELS[] = {
+    {KERNEL_LIFE_BORN, KERNEL_LIFE_SURVIVES, _Kernel_life},
+    {0x048, 0x00C, _Kernel_highlife},
+    {0x1C8, 0x1D8, _Kernel_day_and_night},
+    {0x004, 0x000, _Kernel_seeds},
+    {0x008, 0x1FF, _Kernel_without_death},
+    {0x148, 0x034, _Kernel_morley},
+    {0x008, 0x03E, _Kernel_maze},
+};
+
+/* ================================ */
+
+static void _Kernel_key_create(void) {
+
+    _Kernel_keyed = (pthread_key_create(&_Kernel_key, free) == 0);
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Get the summed-area table of the calling thread, of `SUMS_HEIGHT` * `SUMS_WIDTH` entries.
+ * Allocated by the first Larger than Life step of the thread and freed when the thread exits. NULL if it cannot be allocated.
+*/
+static uint32_t* _Kernel_sums(void) {
+
+    uint32_t* sums = NULL;
+
+    pthread_once(&_Kernel_once, _Kernel_key_create);
+
+    if (!_Kernel_keyed) {
+        return NULL;
+    }
+
+    if ((sums = (uint32_t*) pthread_getspecific(_Kernel_key)) != NULL) {
+        return sums;
+    }
+
+    if ((sums = (uint32_t*) malloc(SUMS_HEIGHT * SUMS_WIDTH * sizeof(uint32_t))) == NULL) {
+        return NULL;
+    }
+
+    if (pthread_setspecific(_Kernel_key, sums) != 0) {
+
+        free(sums);
+
+        return NULL;
+    }
+
+    return sums;
+}
+
+/* ================================ */
+
+/**
+ * Fill the row `line` of a summed-area table from the row `above` it and the cells of the row `row` of `g`, in the columns
+ * `first` .. `first + count - 1`. Both the row and the columns may lie beyond the edges, by as much as the range of a rule.
+ * Cells inside the grid are read straight from the row; only those beyond the left and the right edges go through the edge mode.
+*/
+static void _Kernel_sums_row(uint32_t* line, const uint32_t* above, const Grid_t g, long row, long first, size_t count) {
+
+    const long rows = (long) g->rows;
+    const long columns = (long) g->columns;
+    const long last = first + (long) count;
+
+    const int torus = (g->edge != GRID_DEAD) && (g->edge != GRID_ALIVE);
+    const uint32_t beyond = Grid_beyond(g);
+
+    const uint64_t* words = NULL;
+    const unsigned char* bytes = NULL;
+
+    /* Columns of the row inside the grid */
+    long start = 0;
+    long end = 0;
+
+    long column = first;
+
+    /* Entry of the table holding `column` */
+    size_t x = 1;
+
+    uint32_t acc = 0;
+
+    line[0] = 0;
+
+    /* A row beyond the top or the bottom edge of a bounded grid holds nothing but what lies beyond */
+    if (((row < 0) || (row >= rows)) && !torus) {
+
+        for (; column < last; column++, x++) {
+
+            acc += beyond;
+            line[x] = above[x] + acc;
+        }
+
+        return ;
+    }
+
+    row = (row % rows + rows) % rows;
+
+    words = Grid_row(g, row);
+    bytes = Grid_bytes(g, row);
+
+    start = (first > 0) ? first : 0;
+    end = (last < columns) ? last : columns;
+
+    for (; column < start; column++, x++) {
+
+        acc += torus ? (Grid_get(g, row, (column % columns + columns) % columns) == 1) : beyond;
+        line[x] = above[x] + acc;
+    }
+
+    /* Decaying cells are not alive */
+    if (g->format == GRID_BYTES) {
+
+        for (; column < end; column++, x++) {
+
+            acc += (bytes[column] == 1);
+            line[x] = above[x] + acc;
+        }
+    }
+    else {
+
+        for (; column < end; column++, x++) {
+
+            acc += (uint32_t) (words[column / GRID_WORD] >> (column % GRID_WORD)) & 1;
+            line[x] = above[x] + acc;
+        }
+    }
+
+    for (; column < last; column++, x++) {
+
+        acc += torus ? (Grid_get(g, row, column % columns) == 1) : beyond;
+        line[x] = above[x] + acc;
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Evolve a region of at most a tile under a Larger than Life rule, through the summed-area table `sums`.
+*/
+static void _Kernel_larger_block(Grid_t next, const Grid_t prev, const Rule* rule, uint32_t* sums, size_t top, size_t bottom, size_t left, size_t right) {
+
+    /* A copy, as writing cells through `next` could otherwise alias the rule */
+    const Rule r = *rule;
+
+    const long range = (long) r.range;
+
+    /* The table covers the region and the range around it, after a row and a column of zeros */
+    const size_t side = 2 * (size_t) range + 1;
+    const size_t height = bottom - top + side;
+    const size_t width = right - left + side;
+
+    /* `sums[y * width + x]` is the number of live cells of the rows `top - range` .. `top - range + y - 1`
+     * and the columns `left - range` .. `left - range + x - 1` */
+    const uint32_t* up = NULL;
+    const uint32_t* down = NULL;
+
+    const unsigned char* in = NULL;
+    unsigned char* out = NULL;
+
+    const uint64_t* in_words = NULL;
+    uint64_t* out_words = NULL;
+
+    uint64_t bit = 0;
+
+    size_t y = 0;
+    size_t x = 0;
+    size_t column = 0;
+
+    unsigned count = 0;
+
+    /* State of the cell in the previous generation, and in the next one */
+    unsigned char cell = 0;
+    unsigned char v = 0;
+
+    if ((top >= bottom) || (left >= right)) {
+        return ;
+    }
+
+    memset(sums, 0, width * sizeof(uint32_t));
+
+    for (y = 1; y < height; y++) {
+        _Kernel_sums_row(sums + y * width, sums + (y - 1) * width, prev, (long) (top + y) - range - 1, (long) left - range, width - 1);
+    }
+
+    /* Any square is counted with four reads, however large the range */
+    for (y = 0; y < bottom - top; y++) {
+
+        up = sums + y * width;
+        down = sums + (y + side) * width;
+
+        if (prev->format == GRID_BYTES) {
+
+            in = Grid_bytes(prev, top + y);
+            out = Grid_bytes(next, top + y);
+
+            for (x = 0; x < right - left; x++) {
+
+                count = down[x + side] - up[x + side] - down[x] + up[x];
+
+                cell = in[left + x];
+
+                /* The square holds the cell itself */
+                count -= (cell == 1) && !r.middle;
+
+                out[left + x] = Rule_larger(&r, cell, count);
+            }
+
+            continue ;
+        }
+
+        in_words = Grid_row(prev, top + y);
+        out_words = Grid_row(next, top + y);
+
+        for (x = 0; x < right - left; x++) {
+
+            column = left + x;
+            bit = UINT64_C(1) << (column % GRID_WORD);
+
+            count = down[x + side] - up[x + side] - down[x] + up[x];
+
+            cell = (in_words[column / GRID_WORD] & bit) != 0;
+
+            count -= cell && !r.middle;
+
+            v = Rule_larger(&r, cell, count);
+
+            out_words[column / GRID_WORD] = (out_words[column / GRID_WORD] & ~bit) | ((v != 0) ? bit : 0);
+        }
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+void Kernel_scalar(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right) {
+
+    const int range = (int) rule->range;
+
+    int row = 0;
+    int column = 0;
+
+    /* Offset of a neighbour */
+    int y = 0;
+    int x = 0;
+
+    /* Accumulator */
+    int acc = 0;
+
+    /* State of the cell in the previous generation */
+    unsigned char cell = 0;
+
+    for (row = (int) top; row < (int) bottom; row++) {
+
+        for (column = (int) left; column < (int) right; column++) {
+
+            cell = Grid_get(prev, row, column);
+
+            for (acc = 0, y = -range; y <= range; y++) {
+
+                for (x = -range; x <= range; x++) {
+                    acc += ((y != 0) || (x != 0)) ? _Kernel_cell(prev, row + y, column + x) : 0;
+                }
+            }
+
+            if (range > 1) {
+                Grid_set(next, row, column, Rule_larger(rule, cell, (unsigned) acc + (rule->middle && (cell == 1))));
+            }
+            else {
+                Grid_set(next, row, column, Rule_next(rule, cell, (unsigned) acc));
+            }
+        }
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Kernel_bits(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right) {
+
+    _Kernel_bits(next, prev, top, bottom, left, right, rule->born, rule->survives);
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Kernel_generations(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right) {
+
+    const unsigned char* up = NULL;
+    const unsigned char* mid = NULL;
+    const unsigned char* down = NULL;
+
+    unsigned char* out = NULL;
+
+    /* Read once: the cells written could otherwise alias the rule */
+    const unsigned born = rule->born;
+    const unsigned survives = rule->survives;
+    const unsigned states = rule->states;
+
+    const size_t columns = prev->columns;
+
+    size_t row = 0;
+    size_t column = 0;
+
+    /* Columns whose neighbours all lie in the row */
+    size_t from = 0;
+    size_t to = 0;
+
+    unsigned count = 0;
+    unsigned cell = 0;
+
+    if ((left >= right) || (columns == 0)) {
+        return ;
+    }
+
+    from = (left > 0) ? left : 1;
+    to = (right < columns) ? right : columns - 1;
+
+    for (row = top; row < bottom; row++) {
+
+        up = (const unsigned char*) Grid_above(prev, row);
+        mid = Grid_bytes(prev, row);
+        down = (const unsigned char*) Grid_below(prev, row);
+
+        out = Grid_bytes(next, row);
+
+        /* Only cells in state 1 are alive; the halo holds 1 for live cells too */
+        for (column = from; column < to; column++) {
+
+            count
+                = (up[column - 1] == 1) + (up[column] == 1) + (up[column + 1] == 1)
+                + (mid[column - 1] == 1) + (mid[column + 1] == 1)
+                + (down[column - 1] == 1) + (down[column] == 1) + (down[column + 1] == 1);
+
+            cell = mid[column];
+
+            /* A live cell that does not survive starts decaying like any other */
+            out[column] = (unsigned char) ((cell == 0) ? (born >> count) & 1 : ((cell == 1) && ((survives >> count) & 1)) ? 1 : (cell + 1 < states) ? cell + 1 : 0);
+        }
+
+        /* The first and the last columns, whose neighbours may lie across the edges */
+        if (left == 0) {
+            out[0] = _Kernel_generations_edge(prev, rule, up, mid, down, 0);
+        }
+
+        if ((right == columns) && (columns > 1)) {
+            out[columns - 1] = _Kernel_generations_edge(prev, rule, up, mid, down, columns - 1);
+        }
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Kernel_larger(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right) {
+
+    uint32_t* sums = _Kernel_sums();
+
+    size_t row = 0;
+    size_t column = 0;
+
+    /* Without a table, the cells are counted one at a time */
+    if ((sums == NULL) || (rule->range > RULE_RANGE)) {
+
+        Kernel_scalar(next, prev, rule, top, bottom, left, right);
+
+        return ;
+    }
+
+    /* A region larger than a tile, such as a whole grid, goes through the table a tile at a time */
+    for (row = top; row < bottom; row += TILE_ROWS) {
+
+        for (column = left; column < right; column += TILE_COLUMNS) {
+            _Kernel_larger_block(next, prev, rule, sums, row, (row + TILE_ROWS < bottom) ? row + TILE_ROWS : bottom, column, (column + TILE_COLUMNS < right) ? column + TILE_COLUMNS : right);
+        }
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+
+Kernel_t Kernel_select(const Grid_t g, const Rule* rule) {
+
+    size_t i = 0;
+
+    if (rule->range > 1) {
+        return Kernel_larger;
+    }
+
+    /* Decaying states need a byte per cell; a bit-packed grid only keeps whether cells are alive */
+    if (rule->states > 2) {
+        return (g->format == GRID_BYTES) ? Kernel_generations : Kernel_scalar;
+    }
+
+    /* Byte cells are left to the vector kernels */
+    if (g->format == GRID_BYTES) {
+        return Simd_select();
+    }
+
+    for (i = 0; i < sizeof(KERNELS) / sizeof(KERNELS[0]); i++) {
+
+        if ((KERNELS[i].born == rule->born) && (KERNELS[i].survives == rule->survives)) {
+            return KERNELS[i].kernel;
+        }
+    }
+
+    return Kernel_bits;
+}
+
+/* ================================================================ */
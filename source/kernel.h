@@ -0,0 +1,168 @@
+#ifndef GOL_KERNEL_H
+#define GOL_KERNEL_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define KERNEL_LIFE_BORN 0x008         /* Masks of B3/S23, which `Kernel_word` computes */
+#define KERNEL_LIFE_SURVIVES 0x00C
+
+/* ================================================================ */
+
+/**
+ * An evolution kernel. Compute the cells in the rows `top` .. `bottom - 1` and the columns `left` .. `right - 1`
+ * of the generation following `prev` under `rule` into `next`. Both grids must be of the same size.
+ * What lies beyond the edges is given by the edge mode of `prev`, set with `Grid_halo`.
+ * With a bit-packed grid, `left` must be a multiple of 64 and `right` a multiple of 64 or the width of the grid.
+ * Kernels only write the cells they are given, so disjoint regions can be evolved in parallel.
+*/
+typedef void (*Kernel_t)(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right);
+
+/* ================================================================ */
+
+/**
+ * Compute 64 cells of the next generation at once with bit-sliced full adders.
+ * `u`, `m` and `d` are the cells of the rows above, at and below; `*l` and `*r` the same rows shifted so that every bit holds its neighbour to the west and to the east.
+*/
+static inline uint64_t Kernel_word(uint64_t ul, uint64_t u, uint64_t ur, uint64_t ml, uint64_t m, uint64_t mr, uint64_t dl, uint64_t d, uint64_t dr) {
+
+    /* Sum and carry bits of the three upper, the three lower and the two side neighbours */
+    uint64_t s_u = ul ^ u ^ ur;
+    uint64_t c_u = (ul & u) | ((ul ^ u) & ur);
+
+    uint64_t s_d = dl ^ d ^ dr;
+    uint64_t c_d = (dl & d) | ((dl ^ d) & dr);
+
+    uint64_t s_m = ml ^ mr;
+    uint64_t c_m = ml & mr;
+
+    /* Then the ones and the twos */
+    uint64_t ones = s_u ^ s_d ^ s_m;
+    uint64_t k = (s_u & s_d) | ((s_u ^ s_d) & s_m);
+
+    uint64_t s_2 = c_u ^ c_d ^ c_m;
+    uint64_t c_2 = (c_u & c_d) | ((c_u ^ c_d) & c_m);
+
+    /* 2 or 3 neighbours means exactly one two. A live cell survives with both, a dead one is born with 3 */
+    return ~c_2 & (s_2 ^ k) & (ones | m);
+}
+
+/* ================================================================ */
+
+/**
+ * Compute 64 cells of the next generation at once under any life-like rule, given by its masks `born` and `survives`.
+ * The neighbours are counted in four bit planes, then every count the rule names is matched against them.
+ * Always inlined: with constant masks, only the counts the rule names are matched, and B3/S23 falls back to `Kernel_word`.
+*/
+__attribute__((always_inline))
+static inline uint64_t Kernel_rule(uint64_t ul, uint64_t u, uint64_t ur, uint64_t ml, uint64_t m, uint64_t mr, uint64_t dl, uint64_t d, uint64_t dr, unsigned born, unsigned survives) {
+
+    uint64_t s_u, c_u, s_d, c_d, s_m, c_m, k, s_2, c_2;
+
+    /* Bits of the count: 1, 2, 4 and 8 */
+    uint64_t b0, b1, b2, b3;
+
+    /* Cells whose count is `n` in its two lower bits, and cells whose count is in 0 .. 3, 4 .. 7 and 8 */
+    uint64_t low[4];
+    uint64_t high[3];
+
+    /* Cells with exactly `n` live neighbours */
+    uint64_t equal = 0;
+
+    uint64_t births = 0;
+    uint64_t survivals = 0;
+
+    unsigned n = 0;
+
+    if ((born == KERNEL_LIFE_BORN) && (survives == KERNEL_LIFE_SURVIVES)) {
+        return Kernel_word(ul, u, ur, ml, m, mr, dl, d, dr);
+    }
+
+    s_u = ul ^ u ^ ur;
+    c_u = (ul & u) | ((ul ^ u) & ur);
+
+    s_d = dl ^ d ^ dr;
+    c_d = (dl & d) | ((dl ^ d) & dr);
+
+    s_m = ml ^ mr;
+    c_m = ml & mr;
+
+    b0 = s_u ^ s_d ^ s_m;
+    k = (s_u & s_d) | ((s_u ^ s_d) & s_m);
+
+    s_2 = c_u ^ c_d ^ c_m;
+    c_2 = (c_u & c_d) | ((c_u ^ c_d) & c_m);
+
+    /* The carry of the ones and the sum of the carries add up to the twos; what they carry joins the carry of the carries as the fours */
+    b1 = k ^ s_2;
+    b2 = c_2 ^ (k & s_2);
+    b3 = c_2 & k & s_2;
+
+    low[0] = ~(b0 | b1);
+    low[1] = b0 & ~b1;
+    low[2] = ~b0 & b1;
+    low[3] = b0 & b1;
+
+    /* A count of 8 has no other bit set, and a count with the fours has no eights */
+    high[0] = ~(b2 | b3);
+    high[1] = b2;
+    high[2] = b3;
+
+    #pragma GCC unroll 9
+    for (n = 0; n <= 8; n++) {
+
+        if (((born | survives) >> n) & 1) {
+
+            equal = (n == 8) ? high[2] : high[n / 4] & low[n % 4];
+
+            births |= ((born >> n) & 1) ? equal : 0;
+            survivals |= ((survives >> n) & 1) ? equal : 0;
+        }
+    }
+
+    return (m & survivals) | (~m & births);
+}
+
+/* ================================================================ */
+
+/**
+ * Reference kernel. Count the neighbours of every cell one at a time, under a rule of any range and number of states.
+*/
+extern void Kernel_scalar(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right);
+
+/* ================================================================ */
+
+/**
+ * Word-parallel kernel. Compute 64 cells at once with bit-sliced full adders, under a rule read at run time.
+*/
+extern void Kernel_bits(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right);
+
+/* ================================================================ */
+
+/**
+ * Generations kernel for byte cells. Counts the neighbours in state 1, and ages the decaying cells.
+*/
+extern void Kernel_generations(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right);
+
+/* ================================================================ */
+
+/**
+ * Larger than Life kernel. Counts the live cells of every neighbourhood from a summed-area table of the region and the range around it,
+ * with four reads whatever the range. The table is built a tile at a time, so a tile costs (64 + 2R) * (256 + 2R) additions.
+ * Every thread keeps its own table, allocated once for the largest range.
+*/
+extern void Kernel_larger(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right);
+
+/* ================================================================ */
+
+/**
+ * Pick the fastest kernel able to evolve the grid `g` under `rule`.
+ * Common rules have bit-packed kernels specialized for them at compile time; any other rule runs on the generic ones.
+ * Generations rules need byte cells, which `Kernel_scalar` stands in for on a bit-packed grid, keeping the live cells only.
+*/
+extern Kernel_t Kernel_select(const Grid_t g, const Rule* rule);
+
+/* ================================================================ */
+
+#endif /* GOL_KERNEL_H */
@@ -0,0 +1,133 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/**
+ * Draw the grid lines into the texture of an overlay, through the renderer of the window.
+*/
+static int _Overlay_render(const Overlay_t o, const Window_t w, SDL_Renderer* r) {
+
+    SDL_Texture* target = SDL_GetRenderTarget(r);
+
+    SDL_BlendMode mode = SDL_BLENDMODE_BLEND;
+
+    if (SDL_SetRenderTarget(r, o->texture) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    SDL_GetRenderDrawBlendMode(r, &mode);
+
+    /* Lines replace the transparent pixels instead of blending into them, so they blend into the frame exactly as if drawn onto it */
+    SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_NONE);
+
+    SDL_SetRenderDrawColor(r, 0, 0, 0, 0);
+    SDL_RenderClear(r);
+
+    LilEn_set_colorRGB(o->color[0], o->color[1], o->color[2], o->color[3]);
+
+    Window_display_grid(w, (int) o->cell_size);
+
+    SDL_SetRenderDrawBlendMode(r, mode);
+    SDL_SetRenderTarget(r, target);
+
+    o->stale = 0;
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+int Overlay_draw(Overlay_t* o, const Window_t w, size_t cell_size, const unsigned char color[4]) {
+
+    SDL_Renderer* r = NULL;
+
+    int width = 0;
+    int height = 0;
+
+    if ((o == NULL) || ((w == NULL) && (g_window == NULL))) {
+        return EXIT_FAILURE;
+    }
+
+    r = (w != NULL) ? w->renderer : g_window->renderer;
+
+    if (SDL_GetRendererOutputSize(r, &width, &height) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    /* A resized window needs a texture of its new size */
+    if ((*o != NULL) && (((*o)->width != width) || ((*o)->height != height))) {
+        Overlay_destroy(o);
+    }
+
+    if (*o == NULL) {
+
+        if ((*o = (Overlay_t) calloc(1, sizeof(struct overlay))) == NULL) {
+            return EXIT_FAILURE;
+        }
+
+        if (((*o)->texture = SDL_CreateTexture(r, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height)) == NULL) {
+
+            Overlay_destroy(o);
+
+            return EXIT_FAILURE;
+        }
+
+        SDL_SetTextureBlendMode((*o)->texture, SDL_BLENDMODE_BLEND);
+
+        (*o)->width = width;
+        (*o)->height = height;
+        (*o)->stale = 1;
+    }
+
+    if ((*o)->stale || ((*o)->cell_size != cell_size) || (memcmp((*o)->color, color, sizeof((*o)->color)) != 0)) {
+
+        (*o)->cell_size = cell_size;
+        memcpy((*o)->color, color, sizeof((*o)->color));
+
+        if (_Overlay_render(*o, w, r) == EXIT_FAILURE) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    SDL_RenderCopy(r, (*o)->texture, NULL, NULL);
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+void Overlay_reset(Overlay_t o) {
+
+    if (o == NULL) {
+        return ;
+    }
+
+    o->stale = 1;
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Overlay_destroy(Overlay_t* o) {
+
+    if ((o == NULL) || (*o == NULL)) {
+        return ;
+    }
+
+    if ((*o)->texture != NULL) {
+        SDL_DestroyTexture((*o)->texture);
+    }
+
+    free(*o);
+
+    *o = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
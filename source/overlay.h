@@ -0,0 +1,53 @@
+#ifndef GOL_OVERLAY_H
+#define GOL_OVERLAY_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+/**
+ * Grid lines drawn once into a target texture and copied onto every frame.
+ * The lines are drawn again only when the cell size, the size of the window or their color changes.
+*/
+struct overlay {
+
+    SDL_Texture* texture;
+
+    int width;                  /* Size of the window the lines were drawn for */
+    int height;
+
+    size_t cell_size;           /* Cell size they were drawn for */
+    unsigned char color[4];     /* Color they were drawn in */
+
+    int stale;                  /* Set when the texture has to be drawn again, as its contents were lost */
+};
+
+typedef struct overlay Overlay;
+
+typedef Overlay* Overlay_t;
+
+/* ================================================================ */
+
+/**
+ * Copy the grid lines of a window onto it, drawing them first if the overlay is missing or out of date.
+ * Returns EXIT_FAILURE if the renderer cannot draw into a texture, in which case nothing is drawn.
+*/
+extern int Overlay_draw(Overlay_t* o, const Window_t w, size_t cell_size, const unsigned char color[4]);
+
+/* ================================================================ */
+
+/**
+ * Have the lines drawn again by the next copy. Call it when the renderer loses the contents of its target textures.
+*/
+extern void Overlay_reset(Overlay_t o);
+
+/* ================================================================ */
+
+/**
+ * Deallocate an overlay and set the pointer to NULL. Must be called before its renderer is destroyed.
+*/
+extern void Overlay_destroy(Overlay_t* o);
+
+/* ================================================================ */
+
+#endif /* GOL_OVERLAY_H */
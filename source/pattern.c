@@ -0,0 +1,692 @@
+#include "include.h"
+
+/* Size of the buffer of a pattern file */
+#define BUFFER (1 << 20)
+
+/* Longest header line of an RLE file kept */
+#define HEADER 256
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/**
+ * Set `count` cells of the row `row` to 1, starting at the column `column`. The cells must lie within the grid.
+*/
+static void _Pattern_fill(Grid_t g, size_t row, size_t column, size_t count) {
+
+    uint64_t* words = Grid_row(g, row);
+
+    size_t n = 0;
+
+    if (g->format == GRID_BYTES) {
+
+        memset(Grid_bytes(g, row) + column, 1, count);
+
+        return ;
+    }
+
+    /* Whole words at a time */
+    while (count > 0) {
+
+        n = GRID_WORD - column % GRID_WORD;
+        n = (count < n) ? count : n;
+
+        words[column / GRID_WORD] |= ((n == GRID_WORD) ? ~UINT64_C(0) : ((UINT64_C(1) << n) - 1)) << (column % GRID_WORD);
+
+        column += n;
+        count -= n;
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Place a run of `count` live cells starting at (`row`, `column`) of the grid, dropping the ones outside of it.
+*/
+static void _Pattern_place(Grid_t g, Pattern* p, int64_t row, int64_t column, size_t count) {
+
+    int64_t start = (column > 0) ? column : 0;
+    int64_t end = column + (int64_t) count;
+
+    if (end > (int64_t) g->columns) {
+        end = (int64_t) g->columns;
+    }
+
+    if ((row < 0) || (row >= (int64_t) g->rows) || (start >= end)) {
+
+        p->dropped += count;
+
+        return ;
+    }
+
+    _Pattern_fill(g, (size_t) row, (size_t) start, (size_t) (end - start));
+
+    p->population += (size_t) (end - start);
+    p->dropped += count - (size_t) (end - start);
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Skip the rest of the current line.
+*/
+static void _Pattern_skip(FILE* file) {
+
+    int c = 0;
+
+    while (((c = getc_unlocked(file)) != EOF) && (c != '\n')) ;
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Read an RLE pattern: optional `#` lines, an optional `x = ..., y = ..., rule = ...` header, then runs up to `!`.
+*/
+static int _Pattern_rle(FILE* file, Grid_t g, int64_t top, int64_t left, Pattern* p) {
+
+    char header[HEADER];
+    char* rule = NULL;
+
+    int64_t row = 0;
+    int64_t column = 0;
+
+    size_t count = 0;
+    size_t n = 0;
+    size_t i = 0;
+
+    int c = 0;
+
+    /* Comments and the header */
+    while ((c = getc_unlocked(file)) != EOF) {
+
+        if (isspace(c)) {
+            continue ;
+        }
+
+        if (c == '#') {
+
+            _Pattern_skip(file);
+
+            continue ;
+        }
+
+        if (c != 'x') {
+
+            ungetc(c, file);
+
+            break ;
+        }
+
+        for (i = 0; ((c = getc_unlocked(file)) != EOF) && (c != '\n'); i++) {
+
+            if (i < HEADER - 1) {
+                header[i] = (char) c;
+            }
+        }
+
+        header[(i < HEADER - 1) ? i : HEADER - 1] = '\0';
+
+        sscanf(header, " = %" SCNd64 " , y = %" SCNd64, &p->columns, &p->rows);
+
+        if (((rule = strstr(header, "rule")) != NULL) && ((rule = strchr(rule, '=')) != NULL)) {
+
+            for (rule++; isspace((unsigned char) *rule); rule++) ;
+
+            for (i = 0; (i < SNAPSHOT_RULE - 1) && (rule[i] != '\0') && (rule[i] != ',') && !isspace((unsigned char) rule[i]); i++) {
+                p->rule[i] = rule[i];
+            }
+
+            p->rule[i] = '\0';
+        }
+
+        break ;
+    }
+
+    /* Runs. Cells are placed as they are read */
+    while (((c = getc_unlocked(file)) != EOF) && (c != '!')) {
+
+        if ((c >= '0') && (c <= '9')) {
+
+            count = count * 10 + (size_t) (c - '0');
+
+            continue ;
+        }
+
+        if (isspace(c)) {
+            continue ;
+        }
+
+        n = (count > 0) ? count : 1;
+        count = 0;
+
+        switch (c) {
+
+            case 'b':
+
+            case '.':
+                column += (int64_t) n;
+
+                break ;
+
+            case '$':
+                row += (int64_t) n;
+                column = 0;
+
+                break ;
+
+            case '#':
+                _Pattern_skip(file);
+
+                break ;
+
+            default:
+
+                /* Any other state is alive. States past `X` take a prefix, `p` to `y` */
+                if ((c >= 'p') && (c <= 'y')) {
+                    c = getc_unlocked(file);
+                }
+
+                if ((c != 'o') && !((c >= 'A') && (c <= 'X'))) {
+                    return EXIT_FAILURE;
+                }
+
+                _Pattern_place(g, p, top + row, left + column, n);
+
+                column += (int64_t) n;
+
+                break ;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Read a Life 1.06 pattern: `#` lines, then the column and row of a live cell per line.
+*/
+static int _Pattern_life106(FILE* file, Grid_t g, int64_t top, int64_t left, Pattern* p) {
+
+    int64_t row = 0;
+    int64_t column = 0;
+
+    int64_t min_row = INT64_MAX, max_row = INT64_MIN;
+    int64_t min_column = INT64_MAX, max_column = INT64_MIN;
+
+    int c = 0;
+
+    while ((c = getc_unlocked(file)) != EOF) {
+
+        if (isspace(c)) {
+            continue ;
+        }
+
+        if (c == '#') {
+
+            _Pattern_skip(file);
+
+            continue ;
+        }
+
+        ungetc(c, file);
+
+        if (fscanf(file, "%" SCNd64 " %" SCNd64, &column, &row) != 2) {
+            return EXIT_FAILURE;
+        }
+
+        _Pattern_place(g, p, top + row, left + column, 1);
+
+        min_row = (row < min_row) ? row : min_row;
+        max_row = (row > max_row) ? row : max_row;
+        min_column = (column < min_column) ? column : min_column;
+        max_column = (column > max_column) ? column : max_column;
+    }
+
+    if (min_row <= max_row) {
+
+        p->rows = max_row - min_row + 1;
+        p->columns = max_column - min_column + 1;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Read a plaintext pattern: `!` lines, then a line per row, `O` being a live cell and `.` a dead one.
+*/
+static int _Pattern_cells(FILE* file, Grid_t g, int64_t top, int64_t left, Pattern* p) {
+
+    int64_t row = 0;
+    int64_t column = 0;
+
+    /* Live cells read but not placed yet, ending at `column` */
+    size_t run = 0;
+
+    int start = 1;
+    int c = 0;
+
+    while ((c = getc_unlocked(file)) != EOF) {
+
+        if ((c == '!') && start) {
+
+            _Pattern_skip(file);
+
+            continue ;
+        }
+
+        start = 0;
+
+        if ((c == 'O') || (c == '*')) {
+
+            run++;
+            column++;
+
+            continue ;
+        }
+
+        if (run > 0) {
+
+            _Pattern_place(g, p, top + row, left + column - (int64_t) run, run);
+
+            run = 0;
+        }
+
+        if (c == '\n') {
+
+            p->columns = (column > p->columns) ? column : p->columns;
+
+            row++;
+            column = 0;
+            start = 1;
+        }
+        else if (c != '\r') {
+            column++;
+        }
+    }
+
+    if (run > 0) {
+        _Pattern_place(g, p, top + row, left + column - (int64_t) run, run);
+    }
+
+    p->columns = (column > p->columns) ? column : p->columns;
+    p->rows = row + (column > 0);
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Get the length of the run of cells equal to `v` starting at (`row`, `column`) and ending at `right` at most.
+*/
+static size_t _Pattern_run(const Grid_t g, size_t row, size_t column, size_t right, int v) {
+
+    size_t start = column;
+    size_t rest = 0;
+    size_t n = 0;
+
+    uint64_t w = 0;
+
+    while (column < right) {
+
+        w = Grid_word(g, row, column / GRID_WORD) >> (column % GRID_WORD);
+        w = (v) ? w : ~w;
+
+        /* Number of cells equal to `v`, up to the end of the word */
+        rest = GRID_WORD - column % GRID_WORD;
+
+        n = (~w == 0) ? GRID_WORD : (size_t) __builtin_ctzll(~w);
+        n = (n < rest) ? n : rest;
+
+        column += n;
+
+        /* The run ends within the word */
+        if (n < rest) {
+            break ;
+        }
+    }
+
+    return ((column < right) ? column : right) - start;
+}
+
+/* ================================ */
+
+/**
+ * Find the box around the live cells of a grid: the rows `*top` .. `*bottom - 1` and the columns `*left` .. `*right - 1`.
+ * Returns 0 if there are none.
+*/
+static int _Pattern_box(const Grid_t g, size_t* top, size_t* bottom, size_t* left, size_t* right) {
+
+    size_t words = (g->columns + GRID_WORD - 1) / GRID_WORD;
+    size_t row = 0;
+    size_t word = 0;
+
+    uint64_t w = 0;
+
+    *top = g->rows;
+    *bottom = 0;
+    *left = g->columns;
+    *right = 0;
+
+    for (row = 0; row < g->rows; row++) {
+
+        for (word = 0; word < words; word++) {
+
+            if ((w = Grid_word(g, row, word)) == 0) {
+                continue ;
+            }
+
+            *top = (row < *top) ? row : *top;
+            *bottom = row + 1;
+
+            *left = (word * GRID_WORD + __builtin_ctzll(w) < *left) ? word * GRID_WORD + __builtin_ctzll(w) : *left;
+            *right = (word * GRID_WORD + GRID_WORD - __builtin_clzll(w) > *right) ? word * GRID_WORD + GRID_WORD - __builtin_clzll(w) : *right;
+        }
+    }
+
+    return *top < *bottom;
+}
+
+/* ================================ */
+
+/**
+ * Append `count` times `tag` to an RLE file, starting a new line if the current one would get too long.
+*/
+static void _Pattern_token(FILE* file, size_t* line, size_t count, char tag) {
+
+    char token[24];
+
+    /* Written backwards: the tag, then the digits of the count */
+    size_t n = 0;
+
+    token[sizeof(token) - ++n] = tag;
+
+    /* A count of 1 is left out */
+    for (count = (count > 1) ? count : 0; count > 0; count /= 10) {
+        token[sizeof(token) - ++n] = (char) ('0' + count % 10);
+    }
+
+    if (*line + n > PATTERN_LINE) {
+
+        putc_unlocked('\n', file);
+
+        *line = 0;
+    }
+
+    fwrite(token + sizeof(token) - n, 1, n, file);
+
+    *line += n;
+
+    return ;
+}
+
+/* ================================ */
+
+static void _Pattern_save_rle(FILE* file, const Grid_t g, const char* rule, size_t top, size_t bottom, size_t left, size_t right) {
+
+    /* Length of the current line */
+    size_t line = 0;
+
+    /* Row ends not written yet */
+    size_t ends = 0;
+
+    size_t row = 0;
+    size_t column = 0;
+    size_t dead = 0;
+    size_t live = 0;
+
+    fprintf(file, "x = %zu, y = %zu, rule = %s\n", right - left, bottom - top, rule);
+
+    for (row = top; row < bottom; row++) {
+
+        /* Trailing dead cells are left out */
+        for (column = left; column < right; column += live) {
+
+            column += (dead = _Pattern_run(g, row, column, right, 0));
+
+            if (column >= right) {
+                break ;
+            }
+
+            live = _Pattern_run(g, row, column, right, 1);
+
+            if (ends > 0) {
+
+                _Pattern_token(file, &line, ends, '$');
+
+                ends = 0;
+            }
+
+            if (dead > 0) {
+                _Pattern_token(file, &line, dead, 'b');
+            }
+
+            _Pattern_token(file, &line, live, 'o');
+        }
+
+        ends++;
+    }
+
+    _Pattern_token(file, &line, 1, '!');
+
+    putc('\n', file);
+
+    return ;
+}
+
+/* ================================ */
+
+static void _Pattern_save_life106(FILE* file, const Grid_t g, size_t top, size_t bottom) {
+
+    size_t words = (g->columns + GRID_WORD - 1) / GRID_WORD;
+    size_t row = 0;
+    size_t word = 0;
+
+    uint64_t w = 0;
+
+    fputs("#Life 1.06\n", file);
+
+    for (row = top; row < bottom; row++) {
+
+        for (word = 0; word < words; word++) {
+
+            for (w = Grid_word(g, row, word); w != 0; w &= w - 1) {
+                fprintf(file, "%zu %zu\n", word * GRID_WORD + __builtin_ctzll(w), row);
+            }
+        }
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+static void _Pattern_save_cells(FILE* file, const Grid_t g, const char* filename, size_t top, size_t bottom, size_t left, size_t right) {
+
+    size_t row = 0;
+    size_t column = 0;
+    size_t n = 0;
+    size_t i = 0;
+
+    int v = 0;
+
+    fprintf(file, "!Name: %s\n", (strrchr(filename, '/') != NULL) ? strrchr(filename, '/') + 1 : filename);
+
+    for (row = top; row < bottom; row++) {
+
+        /* Trailing dead cells are left out */
+        for (column = left, v = 0; column < right; column += n, v = !v) {
+
+            n = _Pattern_run(g, row, column, right, v);
+
+            if (!v && (column + n >= right)) {
+                break ;
+            }
+
+            for (i = 0; i < n; i++) {
+                putc((v) ? 'O' : '.', file);
+            }
+        }
+
+        putc('\n', file);
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+int Pattern_format(const char* filename) {
+
+    const char* extension = NULL;
+
+    if ((filename == NULL) || ((extension = strrchr(filename, '.')) == NULL)) {
+        return 0;
+    }
+
+    if (strcmp(extension, ".rle") == 0) {
+        return PATTERN_RLE;
+    }
+
+    if ((strcmp(extension, ".lif") == 0) || (strcmp(extension, ".life") == 0)) {
+        return PATTERN_LIFE106;
+    }
+
+    if (strcmp(extension, ".cells") == 0) {
+        return PATTERN_CELLS;
+    }
+
+    return 0;
+}
+
+/* ================================================================ */
+
+int Pattern_load(const char* filename, Grid_t g, int64_t top, int64_t left, Pattern* p) {
+
+    FILE* file = NULL;
+
+    Pattern pattern = {0};
+
+    char line[16] = {0};
+
+    int status = EXIT_FAILURE;
+
+    if ((filename == NULL) || (g == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    if ((file = fopen(filename, "r")) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    setvbuf(file, NULL, _IOFBF, BUFFER);
+
+    /* Files without a known extension are told apart by their first line */
+    if ((pattern.format = Pattern_format(filename)) == 0) {
+
+        if (fgets(line, sizeof(line), file) != NULL) {
+            pattern.format = (strncmp(line, "#Life 1.06", 10) == 0) ? PATTERN_LIFE106 : (line[0] == '!') ? PATTERN_CELLS : PATTERN_RLE;
+        }
+
+        rewind(file);
+    }
+
+    flockfile(file);
+
+    switch (pattern.format) {
+
+        case PATTERN_LIFE106:
+            status = _Pattern_life106(file, g, top, left, &pattern);
+
+            break ;
+
+        case PATTERN_CELLS:
+            status = _Pattern_cells(file, g, top, left, &pattern);
+
+            break ;
+
+        default:
+            status = _Pattern_rle(file, g, top, left, &pattern);
+
+            break ;
+    }
+
+    funlockfile(file);
+
+    fclose(file);
+
+    if (p != NULL) {
+        *p = pattern;
+    }
+
+    return status;
+}
+
+/* ================================================================ */
+
+int Pattern_save(const char* filename, const Grid_t g, const char* rule) {
+
+    FILE* file = NULL;
+
+    size_t top, bottom, left, right;
+
+    if ((filename == NULL) || (g == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    if ((file = file_create(filename)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    setvbuf(file, NULL, _IOFBF, BUFFER);
+
+    /* An empty grid is an empty box */
+    if (!_Pattern_box(g, &top, &bottom, &left, &right)) {
+        top = bottom = left = right = 0;
+    }
+
+    flockfile(file);
+
+    switch (Pattern_format(filename)) {
+
+        case PATTERN_LIFE106:
+            _Pattern_save_life106(file, g, top, bottom);
+
+            break ;
+
+        case PATTERN_CELLS:
+            _Pattern_save_cells(file, g, filename, top, bottom, left, right);
+
+            break ;
+
+        default:
+            _Pattern_save_rle(file, g, (rule != NULL) ? rule : "B3/S23", top, bottom, left, right);
+
+            break ;
+    }
+
+    funlockfile(file);
+
+    if (fclose(file) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+#undef BUFFER
+#undef HEADER
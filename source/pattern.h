@@ -0,0 +1,60 @@
+#ifndef GOL_PATTERN_H
+#define GOL_PATTERN_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define PATTERN_RLE 1           /* Run-length encoded: `x = 3, y = 3, rule = B3/S23` followed by `bo$2bo$3o!` */
+#define PATTERN_LIFE106 2       /* Life 1.06: `#Life 1.06` followed by a `x y` line per live cell */
+#define PATTERN_CELLS 3         /* Plaintext: `!` comment lines followed by a line of `.` and `O` per row */
+
+#define PATTERN_LINE 70         /* Longest line of an RLE file written */
+
+/* ================================================================ */
+
+/**
+ * What was read from a pattern file.
+*/
+struct pattern {
+
+    int format;                 /* `PATTERN_RLE`, `PATTERN_LIFE106` or `PATTERN_CELLS` */
+
+    int64_t rows;               /* Size of the pattern. With `PATTERN_LIFE106`, the size of the box around its cells */
+    int64_t columns;
+
+    char rule[SNAPSHOT_RULE];   /* Rule of an RLE pattern, or "" if it names none */
+
+    size_t population;          /* Number of live cells placed into the grid */
+    size_t dropped;             /* Number of live cells falling outside of the grid */
+};
+
+typedef struct pattern Pattern;
+
+/* ================================================================ */
+
+/**
+ * Get the format of a pattern file from its extension (.rle, .lif, .life, .cells), or 0 if it has none of them.
+*/
+extern int Pattern_format(const char* filename);
+
+/* ================================================================ */
+
+/**
+ * Read a pattern file straight into `g`, its top left corner at (`top`, `left`), in a single pass.
+ * Live cells are added to the ones already in `g`; dead cells leave them as they are. Cells falling outside of `g` are dropped.
+ * The format is taken from the extension, or from the first line if there is none. `p` may be NULL.
+*/
+extern int Pattern_load(const char* filename, Grid_t g, int64_t top, int64_t left, Pattern* p);
+
+/* ================================================================ */
+
+/**
+ * Write the box around the live cells of `g` into a pattern file in the format given by its extension, RLE if it has none.
+ * `rule` is written into the header of an RLE file.
+*/
+extern int Pattern_save(const char* filename, const Grid_t g, const char* rule);
+
+/* ================================================================ */
+
+#endif /* GOL_PATTERN_H */
@@ -0,0 +1,176 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+static void* _Pool_work(void* arg) {
+
+    struct worker* worker = (struct worker*) arg;
+    Pool_t pool = worker->pool;
+
+    /* Last job this worker has run */
+    size_t seen = 0;
+
+    Job_t job = NULL;
+    void* data = NULL;
+
+    while (1) {
+
+        pthread_mutex_lock(&pool->lock);
+
+        while ((pool->round == seen) && !pool->quit) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+
+        if (pool->quit) {
+
+            pthread_mutex_unlock(&pool->lock);
+
+            break ;
+        }
+
+        seen = pool->round;
+        job = pool->job;
+        data = pool->arg;
+
+        pthread_mutex_unlock(&pool->lock);
+
+        job(data, worker->index, pool->size);
+
+        pthread_mutex_lock(&pool->lock);
+
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->idle);
+        }
+
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return NULL;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+Pool_t Pool_new(size_t size) {
+
+    Pool_t pool = NULL;
+
+    size_t i = 0;
+
+    long cpus = 0;
+
+    if (size == 0) {
+        size = ((cpus = sysconf(_SC_NPROCESSORS_ONLN)) > 0) ? (size_t) cpus : 1;
+    }
+
+    if ((pool = (Pool_t) calloc(1, sizeof(struct pool))) == NULL) {
+        return NULL;
+    }
+
+    pool->size = size;
+
+    if ((pool->workers = (struct worker*) calloc(size, sizeof(struct worker))) == NULL) {
+
+        free(pool);
+
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+
+    for (i = 1; i < size; i++) {
+
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+
+        if (pthread_create(&pool->workers[i].thread, NULL, _Pool_work, &pool->workers[i]) != 0) {
+
+            /* Keep the threads that did start */
+            pool->size = i;
+
+            break ;
+        }
+    }
+
+    return pool;
+}
+
+/* ================================================================ */
+
+void Pool_run(Pool_t pool, Job_t job, void* arg) {
+
+    if ((pool == NULL) || (job == NULL)) {
+        return ;
+    }
+
+    if (pool->size == 1) {
+
+        job(arg, 0, 1);
+
+        return ;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+
+    pool->job = job;
+    pool->arg = arg;
+    pool->pending = pool->size - 1;
+    pool->round++;
+
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    /* The calling thread takes its share as well ... */
+    job(arg, 0, pool->size);
+
+    /* ... and waits for the rest */
+    pthread_mutex_lock(&pool->lock);
+
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Pool_destroy(Pool_t* pool) {
+
+    size_t i = 0;
+
+    if ((pool == NULL) || (*pool == NULL)) {
+        return ;
+    }
+
+    pthread_mutex_lock(&(*pool)->lock);
+
+    (*pool)->quit = 1;
+
+    pthread_cond_broadcast(&(*pool)->wake);
+    pthread_mutex_unlock(&(*pool)->lock);
+
+    for (i = 1; i < (*pool)->size; i++) {
+        pthread_join((*pool)->workers[i].thread, NULL);
+    }
+
+    pthread_mutex_destroy(&(*pool)->lock);
+    pthread_cond_destroy(&(*pool)->wake);
+    pthread_cond_destroy(&(*pool)->idle);
+
+    free((*pool)->workers);
+    free(*pool);
+
+    *pool = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
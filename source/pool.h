@@ -0,0 +1,73 @@
+#ifndef GOL_POOL_H
+#define GOL_POOL_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+/**
+ * A job run by every thread of a pool. `index` is the number of the thread (0 is the calling one), `size` is the number of threads.
+*/
+typedef void (*Job_t)(void* arg, size_t index, size_t size);
+
+/* ================================================================ */
+
+struct worker {
+
+    struct pool* pool;  /* Pool the worker belongs to */
+
+    size_t index;       /* Number of the worker. The thread calling `Pool_run` is 0 */
+
+    pthread_t thread;
+};
+
+/* ================================ */
+
+struct pool {
+
+    size_t size;                /* Number of threads, including the one calling `Pool_run` */
+
+    struct worker* workers;     /* `size - 1` persistent workers */
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        /* Signalled when a new job is posted */
+    pthread_cond_t idle;        /* Signalled when the last worker finishes a job */
+
+    size_t round;               /* Number of jobs posted so far */
+    size_t pending;             /* Number of workers still running the current job */
+
+    Job_t job;                  /* Current job */
+    void* arg;                  /* Argument of the current job */
+
+    int quit;                   /* Set when the pool is being destroyed */
+};
+
+typedef struct pool Pool;
+
+typedef Pool* Pool_t;
+
+/* ================================================================ */
+
+/**
+ * Create a pool of `size` threads. The calling thread counts as one of them, so `size - 1` threads are started.
+ * A `size` of 0 means one thread per online CPU.
+*/
+extern Pool_t Pool_new(size_t size);
+
+/* ================================================================ */
+
+/**
+ * Run `job` on every thread of the pool and return once all of them are done.
+*/
+extern void Pool_run(Pool_t pool, Job_t job, void* arg);
+
+/* ================================================================ */
+
+/**
+ * Stop and join all threads of the pool, deallocate it and set the pointer to NULL.
+*/
+extern void Pool_destroy(Pool_t* pool);
+
+/* ================================================================ */
+
+#endif /* GOL_POOL_H */
@@ -0,0 +1,676 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/* Side of a node of level `level` */
+#define SIDE(level) ((int64_t) 1 << (level))
+
+/* ================================ */
+
+static size_t _Quad_hash(const struct node* nw, const struct node* ne, const struct node* sw, const struct node* se) {
+
+    uint64_t h = (uintptr_t) nw;
+
+    h = h * UINT64_C(0x9E3779B97F4A7C15) + (uintptr_t) ne;
+    h = h * UINT64_C(0x9E3779B97F4A7C15) + (uintptr_t) sw;
+    h = h * UINT64_C(0x9E3779B97F4A7C15) + (uintptr_t) se;
+
+    return (size_t) (h ^ (h >> 29));
+}
+
+/* ================================ */
+
+/**
+ * Double the number of buckets. The table is left as it is if there is no memory for it.
+*/
+static void _Quad_grow(Quad_t q) {
+
+    struct node** table = NULL;
+    struct node* n = NULL;
+    struct node* next = NULL;
+
+    size_t i = 0;
+    size_t h = 0;
+
+    if ((table = (struct node**) calloc(q->buckets * 2, sizeof(struct node*))) == NULL) {
+        return ;
+    }
+
+    for (i = 0; i < q->buckets; i++) {
+
+        for (n = q->table[i]; n != NULL; n = next) {
+
+            next = n->next;
+
+            h = _Quad_hash(n->nw, n->ne, n->sw, n->se) & (q->buckets * 2 - 1);
+
+            n->next = table[h];
+            table[h] = n;
+        }
+    }
+
+    free(q->table);
+
+    q->table = table;
+    q->buckets *= 2;
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Get the canonical node made of four quadrants. Returns NULL if any quadrant is NULL or there is no memory left.
+*/
+static struct node* _Quad_node(Quad_t q, struct node* nw, struct node* ne, struct node* sw, struct node* se) {
+
+    struct node* n = NULL;
+    struct block* b = NULL;
+
+    size_t h = 0;
+    size_t i = 0;
+
+    if ((nw == NULL) || (ne == NULL) || (sw == NULL) || (se == NULL)) {
+        return NULL;
+    }
+
+    h = _Quad_hash(nw, ne, sw, se) & (q->buckets - 1);
+
+    for (n = q->table[h]; n != NULL; n = n->next) {
+
+        if ((n->nw == nw) && (n->ne == ne) && (n->sw == sw) && (n->se == se)) {
+            return n;
+        }
+    }
+
+    if (q->free == NULL) {
+
+        if ((b = (struct block*) malloc(sizeof(struct block))) == NULL) {
+            return NULL;
+        }
+
+        b->next = q->blocks;
+        q->blocks = b;
+
+        for (i = 0; i < QUAD_BLOCK; i++) {
+            b->nodes[i].next = q->free;
+            q->free = &b->nodes[i];
+        }
+
+        q->allocated += QUAD_BLOCK;
+    }
+
+    n = q->free;
+    q->free = n->next;
+
+    *n = (struct node) {
+        .nw = nw, .ne = ne, .sw = sw, .se = se,
+        .population = nw->population + ne->population + sw->population + se->population,
+        .level = nw->level + 1,
+        .next = q->table[h],
+    };
+
+    q->table[h] = n;
+
+    if (++q->nodes > q->buckets) {
+        _Quad_grow(q);
+    }
+
+    return n;
+}
+
+/* ================================ */
+
+static struct node* _Quad_zero(Quad_t q, unsigned level) {
+
+    struct node* z = NULL;
+
+    if (level == 0) {
+        return &q->cells[0];
+    }
+
+    if (q->zero[level] == NULL) {
+
+        z = _Quad_zero(q, level - 1);
+
+        q->zero[level] = _Quad_node(q, z, z, z, z);
+    }
+
+    return q->zero[level];
+}
+
+/* ================================ */
+
+/**
+ * Get the centre half of a node, without advancing it.
+*/
+static struct node* _Quad_centre(Quad_t q, const struct node* n) {
+    return _Quad_node(q, n->nw->se, n->ne->sw, n->sw->ne, n->se->nw);
+}
+
+/* ================================ */
+
+/**
+ * Advance the centre 2 * 2 cells of a 4 * 4 node by one generation.
+*/
+static struct node* _Quad_base(Quad_t q, const struct node* n) {
+
+    unsigned b = 0;
+    unsigned r = 0;
+
+    #define CELL(m, bit) ((unsigned) (m)->population << (bit))
+
+    b = CELL(n->nw->nw, 0) | CELL(n->nw->ne, 1) | CELL(n->ne->nw, 2) | CELL(n->ne->ne, 3)
+        | CELL(n->nw->sw, 4) | CELL(n->nw->se, 5) | CELL(n->ne->sw, 6) | CELL(n->ne->se, 7)
+        | CELL(n->sw->nw, 8) | CELL(n->sw->ne, 9) | CELL(n->se->nw, 10) | CELL(n->se->ne, 11)
+        | CELL(n->sw->sw, 12) | CELL(n->sw->se, 13) | CELL(n->se->sw, 14) | CELL(n->se->se, 15);
+
+    #undef CELL
+
+    r = q->life[b];
+
+    return _Quad_node(q, &q->cells[r & 1], &q->cells[(r >> 1) & 1], &q->cells[(r >> 2) & 1], &q->cells[(r >> 3) & 1]);
+}
+
+/* ================================ */
+
+/**
+ * Get the centre half of a node advanced 2^min(step, level - 2) generations. Results are memoized on the node.
+*/
+static struct node* _Quad_result(Quad_t q, struct node* n) {
+
+    /* The nine overlapping quarter-size nodes of `n`, row by row */
+    struct node* s[9];
+
+    struct node* r = NULL;
+
+    size_t i = 0;
+
+    if (n == NULL) {
+        return NULL;
+    }
+
+    if (n->result != NULL) {
+        return n->result;
+    }
+
+    if (n->population == 0) {
+        return (n->result = _Quad_zero(q, n->level - 1));
+    }
+
+    if (n->level == 2) {
+        return (n->result = _Quad_base(q, n));
+    }
+
+    s[0] = n->nw;
+    s[1] = _Quad_node(q, n->nw->ne, n->ne->nw, n->nw->se, n->ne->sw);
+    s[2] = n->ne;
+    s[3] = _Quad_node(q, n->nw->sw, n->nw->se, n->sw->nw, n->sw->ne);
+    s[4] = _Quad_node(q, n->nw->se, n->ne->sw, n->sw->ne, n->se->nw);
+    s[5] = _Quad_node(q, n->ne->sw, n->ne->se, n->se->nw, n->se->ne);
+    s[6] = n->sw;
+    s[7] = _Quad_node(q, n->sw->ne, n->se->nw, n->sw->se, n->se->sw);
+    s[8] = n->se;
+
+    for (i = 0; i < 9; i++) {
+
+        if (s[i] == NULL) {
+            return NULL;
+        }
+
+        /* A full step advances both halves; a shorter one only the second */
+        s[i] = (q->step + 2 >= n->level) ? _Quad_result(q, s[i]) : _Quad_centre(q, s[i]);
+    }
+
+    r = _Quad_node(q,
+        _Quad_result(q, _Quad_node(q, s[0], s[1], s[3], s[4])),
+        _Quad_result(q, _Quad_node(q, s[1], s[2], s[4], s[5])),
+        _Quad_result(q, _Quad_node(q, s[3], s[4], s[6], s[7])),
+        _Quad_result(q, _Quad_node(q, s[4], s[5], s[7], s[8])));
+
+    return (n->result = r);
+}
+
+/* ================================ */
+
+/**
+ * Surround the root with empty cells, doubling its side. The cells keep their coordinates.
+*/
+static int _Quad_expand(Quad_t q) {
+
+    struct node* z = NULL;
+    struct node* r = q->root;
+
+    if (r->level >= QUAD_LEVELS) {
+        return EXIT_FAILURE;
+    }
+
+    z = _Quad_zero(q, r->level - 1);
+
+    r = _Quad_node(q,
+        _Quad_node(q, z, z, z, r->nw),
+        _Quad_node(q, z, z, r->ne, z),
+        _Quad_node(q, z, r->sw, z, z),
+        _Quad_node(q, r->se, z, z, z));
+
+    if (r == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    q->root = r;
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Check whether every live cell lies in the centre quarter of the root, so nothing escapes while the root is advanced.
+*/
+static int _Quad_is_padded(const Quad_t q) {
+
+    const struct node* r = q->root;
+
+    return (r->level >= 3)
+        && (r->nw->se->se->population + r->ne->sw->sw->population + r->sw->ne->ne->population + r->se->nw->nw->population == r->population);
+}
+
+/* ================================ */
+
+/**
+ * Build the node of level `level` whose top left cell is (`row`, `column`) from the cells of `g`.
+*/
+static struct node* _Quad_build(Quad_t q, const Grid_t g, unsigned level, int64_t row, int64_t column) {
+
+    int64_t half = 0;
+
+    if ((row >= (int64_t) g->rows) || (column >= (int64_t) g->columns) || (row + SIDE(level) <= 0) || (column + SIDE(level) <= 0)) {
+        return _Quad_zero(q, level);
+    }
+
+    if (level == 0) {
+        return &q->cells[Grid_get(g, row, column) != 0];
+    }
+
+    half = SIDE(level - 1);
+
+    return _Quad_node(q,
+        _Quad_build(q, g, level - 1, row, column),
+        _Quad_build(q, g, level - 1, row, column + half),
+        _Quad_build(q, g, level - 1, row + half, column),
+        _Quad_build(q, g, level - 1, row + half, column + half));
+}
+
+/* ================================ */
+
+/**
+ * Copy the live cells of the node whose top left cell is (`row`, `column`) into `g`.
+*/
+static void _Quad_write(const struct node* n, Grid_t g, int64_t row, int64_t column) {
+
+    int64_t half = 0;
+
+    if ((n->population == 0) || (row >= (int64_t) g->rows) || (column >= (int64_t) g->columns) || (row + SIDE(n->level) <= 0) || (column + SIDE(n->level) <= 0)) {
+        return ;
+    }
+
+    if (n->level == 0) {
+
+        Grid_set(g, row, column, 1);
+
+        return ;
+    }
+
+    half = SIDE(n->level - 1);
+
+    _Quad_write(n->nw, g, row, column);
+    _Quad_write(n->ne, g, row, column + half);
+    _Quad_write(n->sw, g, row + half, column);
+    _Quad_write(n->se, g, row + half, column + half);
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Get the node whose top left cell is (`top`, `left`) with the cell at (`row`, `column`) set to `v`.
+*/
+static struct node* _Quad_put(Quad_t q, struct node* n, int64_t top, int64_t left, int64_t row, int64_t column, int v) {
+
+    int64_t half = 0;
+
+    if (n->level == 0) {
+        return &q->cells[v != 0];
+    }
+
+    half = SIDE(n->level - 1);
+
+    if (row < top + half) {
+
+        return (column < left + half)
+            ? _Quad_node(q, _Quad_put(q, n->nw, top, left, row, column, v), n->ne, n->sw, n->se)
+            : _Quad_node(q, n->nw, _Quad_put(q, n->ne, top, left + half, row, column, v), n->sw, n->se);
+    }
+
+    return (column < left + half)
+        ? _Quad_node(q, n->nw, n->ne, _Quad_put(q, n->sw, top + half, left, row, column, v), n->se)
+        : _Quad_node(q, n->nw, n->ne, n->sw, _Quad_put(q, n->se, top + half, left + half, row, column, v));
+}
+
+/* ================================ */
+
+static void _Quad_mark(struct node* n) {
+
+    if ((n == NULL) || n->mark) {
+        return ;
+    }
+
+    n->mark = 1;
+
+    _Quad_mark(n->nw);
+    _Quad_mark(n->ne);
+    _Quad_mark(n->sw);
+    _Quad_mark(n->se);
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Forget the results of nodes above the level `level`: only those depend on the step.
+*/
+static void _Quad_forget(Quad_t q, unsigned level) {
+
+    struct node* n = NULL;
+
+    size_t i = 0;
+
+    for (i = 0; i < q->buckets; i++) {
+
+        for (n = q->table[i]; n != NULL; n = n->next) {
+
+            if (n->level > level) {
+                n->result = NULL;
+            }
+        }
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+Quad_t Quad_new(size_t memory, const Rule* rule) {
+
+    Quad_t q = NULL;
+
+    /* Neighbours of a cell of the 4 * 4 block */
+    unsigned count = 0;
+
+    unsigned b, i, r, c, y, x;
+
+    /* Empty nodes are taken to stay empty */
+    if ((rule == NULL) || !Rule_is_planar(rule)) {
+        return NULL;
+    }
+
+    if ((q = (Quad_t) calloc(1, sizeof(struct quad))) == NULL) {
+        return NULL;
+    }
+
+    q->buckets = 1 << 16;
+    q->limit = memory / sizeof(struct node);
+
+    if ((q->table = (struct node**) calloc(q->buckets, sizeof(struct node*))) == NULL) {
+
+        free(q);
+
+        return NULL;
+    }
+
+    /* Cells are never collected */
+    q->cells[0] = (struct node) {.population = 0, .mark = 1};
+    q->cells[1] = (struct node) {.population = 1, .mark = 1};
+
+    for (b = 0; b < (1 << 16); b++) {
+
+        for (i = 0; i < 4; i++) {
+
+            r = 1 + i / 2;
+            c = 1 + i % 2;
+
+            count = 0;
+
+            for (y = r - 1; y <= r + 1; y++) {
+
+                for (x = c - 1; x <= c + 1; x++) {
+                    count += ((y != r) || (x != c)) && ((b >> (4 * y + x)) & 1);
+                }
+            }
+
+            if (Rule_next(rule, (b >> (4 * r + c)) & 1, count)) {
+                q->life[b] |= 1 << i;
+            }
+        }
+    }
+
+    if ((q->root = _Quad_zero(q, 3)) == NULL) {
+
+        Quad_destroy(&q);
+
+        return NULL;
+    }
+
+    return q;
+}
+
+/* ================================================================ */
+
+int Quad_import(Quad_t q, const Grid_t g) {
+
+    struct node* r = NULL;
+
+    unsigned level = 3;
+
+    if ((q == NULL) || (g == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    /* The root spans -2^(level - 1) .. 2^(level - 1) - 1 both ways */
+    while ((SIDE(level - 1) < (int64_t) g->rows) || (SIDE(level - 1) < (int64_t) g->columns)) {
+        level++;
+    }
+
+    if ((r = _Quad_build(q, g, level, -SIDE(level - 1), -SIDE(level - 1))) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    q->root = r;
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+void Quad_export(const Quad_t q, Grid_t g) {
+
+    if ((q == NULL) || (g == NULL)) {
+        return ;
+    }
+
+    Grid_clear(g, 0);
+
+    _Quad_write(q->root, g, -SIDE(q->root->level - 1), -SIDE(q->root->level - 1));
+
+    return ;
+}
+
+/* ================================================================ */
+
+int Quad_set(Quad_t q, int64_t row, int64_t column, int v) {
+
+    struct node* r = NULL;
+
+    if (q == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    while ((row < -SIDE(q->root->level - 1)) || (row >= SIDE(q->root->level - 1)) || (column < -SIDE(q->root->level - 1)) || (column >= SIDE(q->root->level - 1))) {
+
+        if (_Quad_expand(q) == EXIT_FAILURE) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((r = _Quad_put(q, q->root, -SIDE(q->root->level - 1), -SIDE(q->root->level - 1), row, column, v)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    q->root = r;
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+int Quad_step(Quad_t q, unsigned step) {
+
+    struct node* r = NULL;
+
+    if ((q == NULL) || (step + 3 > QUAD_LEVELS)) {
+        return EXIT_FAILURE;
+    }
+
+    if (step != q->step) {
+
+        _Quad_forget(q, ((step < q->step) ? step : q->step) + 2);
+
+        q->step = step;
+    }
+
+    /* The root must be big enough to advance 2^step generations at once, and leave room for the pattern to grow */
+    while ((q->root->level < step + 3) || !_Quad_is_padded(q)) {
+
+        if (_Quad_expand(q) == EXIT_FAILURE) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((r = _Quad_result(q, q->root)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    q->root = r;
+
+    if ((q->limit > 0) && (q->nodes > q->limit)) {
+        Quad_collect(q);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+void Quad_collect(Quad_t q) {
+
+    struct node** link = NULL;
+    struct node* n = NULL;
+
+    size_t i = 0;
+
+    if (q == NULL) {
+        return ;
+    }
+
+    _Quad_mark(q->root);
+
+    for (i = 0; i <= QUAD_LEVELS; i++) {
+        _Quad_mark(q->zero[i]);
+    }
+
+    /* Results of the nodes kept must not point to the nodes freed */
+    for (i = 0; i < q->buckets; i++) {
+
+        for (n = q->table[i]; n != NULL; n = n->next) {
+
+            if (n->mark && (n->result != NULL) && !n->result->mark) {
+                n->result = NULL;
+            }
+        }
+    }
+
+    for (i = 0; i < q->buckets; i++) {
+
+        for (link = &q->table[i]; (n = *link) != NULL; ) {
+
+            if (n->mark) {
+
+                n->mark = 0;
+                link = &n->next;
+
+                continue ;
+            }
+
+            *link = n->next;
+
+            n->next = q->free;
+            q->free = n;
+
+            q->nodes--;
+        }
+    }
+
+    q->collections++;
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Quad_log(const Quad_t q) {
+
+    if (q == NULL) {
+        return ;
+    }
+
+    printf("%-16s: %ld\n", "population", (size_t) q->root->population);
+    printf("%-16s: %ld (%.1f MiB allocated)\n", "nodes", q->nodes, q->allocated * sizeof(struct node) / 1048576.0);
+    printf("%-16s: %ld\n", "collections", q->collections);
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Quad_destroy(Quad_t* q) {
+
+    struct block* b = NULL;
+
+    if ((q == NULL) || (*q == NULL)) {
+        return ;
+    }
+
+    while ((b = (*q)->blocks) != NULL) {
+
+        (*q)->blocks = b->next;
+
+        free(b);
+    }
+
+    free((*q)->table);
+    free(*q);
+
+    *q = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
+
+#undef SIDE
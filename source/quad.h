@@ -0,0 +1,134 @@
+#ifndef GOL_QUAD_H
+#define GOL_QUAD_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define QUAD_LEVELS 62          /* Highest level of a node. A node of level `l` is a square of 2^l * 2^l cells */
+#define QUAD_BLOCK 4096         /* Number of nodes allocated at once */
+
+/* ================================================================ */
+
+/**
+ * A square of cells. Nodes are canonical: two nodes holding the same cells are the same node, so they are compared by address.
+*/
+struct node {
+
+    struct node* nw;            /* Quadrants. NULL for a single cell */
+    struct node* ne;
+    struct node* sw;
+    struct node* se;
+
+    struct node* result;        /* The centre of the node advanced 2^min(step, level - 2) generations. NULL until computed */
+
+    struct node* next;          /* Next node of the same hash bucket, or of the free list */
+
+    uint64_t population;        /* Number of live cells */
+
+    uint32_t level;
+    uint32_t mark;              /* Set while collecting garbage for the nodes in use */
+};
+
+/* ================================ */
+
+struct block {
+
+    struct block* next;
+
+    struct node nodes[QUAD_BLOCK];
+};
+
+/* ================================ */
+
+/**
+ * An unbounded plane of cells stored as a hashed quadtree (HashLife).
+ * The root is centred on (0, 0); cell (`row`, `column`) of a world is the point (`column`, `row`) of the plane.
+*/
+struct quad {
+
+    struct node** table;        /* Hash table of every node of level 1 and above */
+    size_t buckets;             /* Number of buckets. A power of two */
+    size_t nodes;               /* Number of nodes in the table */
+
+    size_t limit;               /* Number of nodes above which unused ones are collected after a step. 0 - no limit */
+    size_t collections;         /* Number of garbage collections so far */
+
+    struct block* blocks;       /* Memory of the nodes */
+    struct node* free;          /* Nodes of the blocks not in use */
+    size_t allocated;           /* Number of nodes in the blocks */
+
+    struct node cells[2];       /* The dead and the live cell (level 0) */
+    struct node* zero[QUAD_LEVELS + 1];     /* Empty node of every level. Created on demand */
+
+    struct node* root;
+
+    unsigned step;              /* `Quad_step` advances 2^step generations. Results are only valid for this step */
+
+    unsigned char life[1 << 16];    /* For every 4 * 4 block of cells (bit `4 * row + column`), its 2 * 2 centre a generation later (bits nw, ne, sw, se) */
+};
+
+typedef struct quad Quad;
+
+typedef Quad* Quad_t;
+
+/* ================================================================ */
+
+/**
+ * Create an empty plane evolving under `rule`, which must be planar (see `Rule_is_planar`).
+ * Once more than `memory` bytes are taken by nodes, unused ones are collected between steps. 0 - no limit.
+*/
+extern Quad_t Quad_new(size_t memory, const Rule* rule);
+
+/* ================================================================ */
+
+/**
+ * Replace the whole plane by the cells of `g`.
+*/
+extern int Quad_import(Quad_t q, const Grid_t g);
+
+/* ================================================================ */
+
+/**
+ * Copy the part of the plane covered by `g` into `g`. Cells outside of it are kept in the plane.
+*/
+extern void Quad_export(const Quad_t q, Grid_t g);
+
+/* ================================================================ */
+
+/**
+ * Set the cell at (`row`, `column`) to `v`.
+*/
+extern int Quad_set(Quad_t q, int64_t row, int64_t column, int v);
+
+/* ================================================================ */
+
+/**
+ * Advance the plane by 2^`step` generations.
+*/
+extern int Quad_step(Quad_t q, unsigned step);
+
+/* ================================================================ */
+
+/**
+ * Free every node not reachable from the root. Memoized results pointing to freed nodes are forgotten.
+*/
+extern void Quad_collect(Quad_t q);
+
+/* ================================================================ */
+
+/**
+ * Print the size of the quadtree.
+*/
+extern void Quad_log(const Quad_t q);
+
+/* ================================================================ */
+
+/**
+ * Deallocate the plane and set the pointer to NULL.
+*/
+extern void Quad_destroy(Quad_t* q);
+
+/* ================================================================ */
+
+#endif /* GOL_QUAD_H */
@@ -0,0 +1,651 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/**
+ * Make room for `size` more bytes in the payload buffer.
+*/
+static int _Record_reserve(Record_t r, size_t used, size_t size) {
+
+    unsigned char* buffer = NULL;
+
+    size_t capacity = (r->capacity > 0) ? r->capacity : 4096;
+
+    if (used + size <= r->capacity) {
+        return EXIT_SUCCESS;
+    }
+
+    while (used + size > capacity) {
+        capacity *= 2;
+    }
+
+    if ((buffer = (unsigned char*) realloc(r->buffer, capacity)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    r->buffer = buffer;
+    r->capacity = capacity;
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Append a LEB128 varint to the payload buffer.
+*/
+static int _Record_varint(Record_t r, size_t* used, uint64_t v) {
+
+    if (_Record_reserve(r, *used, 10) == EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    while (v >= 0x80) {
+
+        r->buffer[(*used)++] = (unsigned char) ((v & 0x7F) | 0x80);
+
+        v >>= 7;
+    }
+
+    r->buffer[(*used)++] = (unsigned char) v;
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Encode `count` words as runs of 0 and 1 bits into the payload buffer and get the size of the payload through `size`.
+*/
+static int _Record_encode(Record_t r, const uint64_t* words, size_t count, size_t* size) {
+
+    int state = 0;
+    uint64_t run = 0;
+
+    uint64_t w = 0;
+
+    /* Bits of `w` not looked at yet, and the length of the part of them in the current state */
+    size_t n = 0;
+    size_t k = 0;
+
+    size_t i = 0;
+
+    *size = 0;
+
+    for (i = 0; i < count; i++) {
+
+        w = words[i];
+
+        for (n = GRID_WORD; n > 0; ) {
+
+            k = ((state ? ~w : w) != 0) ? (size_t) __builtin_ctzll(state ? ~w : w) : GRID_WORD;
+            k = (k < n) ? k : n;
+
+            run += k;
+            n -= k;
+            w = (k < GRID_WORD) ? w >> k : 0;
+
+            if (n > 0) {
+
+                if (_Record_varint(r, size, run) == EXIT_FAILURE) {
+                    return EXIT_FAILURE;
+                }
+
+                run = 0;
+                state = !state;
+            }
+        }
+    }
+
+    return (run > 0) ? _Record_varint(r, size, run) : EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Flip the bits `from` .. `to - 1` of an array of words.
+*/
+static void _Record_flip(uint64_t* words, uint64_t from, uint64_t to) {
+
+    uint64_t length = 0;
+
+    while (from < to) {
+
+        length = GRID_WORD - from % GRID_WORD;
+        length = (length < to - from) ? length : to - from;
+
+        words[from / GRID_WORD] ^= ((length < GRID_WORD) ? (UINT64_C(1) << length) - 1 : ~UINT64_C(0)) << (from % GRID_WORD);
+
+        from += length;
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Flip the bits of `count` words set in an encoded payload.
+*/
+static void _Record_decode(const unsigned char* payload, size_t size, uint64_t* words, size_t count) {
+
+    int state = 0;
+
+    uint64_t run = 0;
+    uint64_t p = 0;
+    uint64_t total = (uint64_t) count * GRID_WORD;
+
+    unsigned shift = 0;
+
+    size_t i = 0;
+
+    while ((i < size) && (p < total)) {
+
+        for (run = 0, shift = 0; (i < size) && (shift < 64); shift += 7) {
+
+            run |= (uint64_t) (payload[i] & 0x7F) << shift;
+
+            if ((payload[i++] & 0x80) == 0) {
+                break ;
+            }
+        }
+
+        run = (run < total - p) ? run : total - p;
+
+        if (state) {
+            _Record_flip(words, p, p + run);
+        }
+
+        p += run;
+        state = !state;
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Write a generation as a frame: a keyframe every `RECORD_KEYFRAME` frames, a delta against the previous frame otherwise.
+*/
+static void _Record_write(Record_t r, const uint64_t* cells, size_t generation) {
+
+    unsigned char header[RECORD_FRAME];
+
+    uint64_t* keys = NULL;
+
+    size_t count = r->rows * r->words;
+    size_t size = 0;
+    size_t i = 0;
+
+    int key = !r->written || (r->since + 1 >= RECORD_KEYFRAME);
+
+    long offset = ftell(r->file);
+
+    /* A delta holds the cells that differ from the previous frame */
+    if (!key) {
+
+        for (i = 0; i < count; i++) {
+            r->previous[i] ^= cells[i];
+        }
+    }
+
+    if (_Record_encode(r, key ? cells : r->previous, count, &size) == EXIT_FAILURE) {
+
+        pthread_mutex_lock(&r->lock);
+        r->dropped++;
+        pthread_mutex_unlock(&r->lock);
+
+        /* The next frame cannot be a delta of this one */
+        r->written = 0;
+
+        return ;
+    }
+
+    if (key) {
+
+        if (r->nkeys == r->kcapacity) {
+
+            if ((keys = (uint64_t*) realloc(r->keys, 2 * (r->kcapacity * 2 + 1) * sizeof(uint64_t))) != NULL) {
+                r->keys = keys;
+                r->kcapacity = r->kcapacity * 2 + 1;
+            }
+        }
+
+        if (r->nkeys < r->kcapacity) {
+            r->keys[2 * r->nkeys] = generation;
+            r->keys[2 * r->nkeys + 1] = (uint64_t) offset;
+            r->nkeys++;
+        }
+    }
+
+    header[0] = key ? RECORD_KEY : RECORD_DELTA;
+
+    Snapshot_put(header + 1, generation, 8);
+    Snapshot_put(header + 9, size, 8);
+
+    fwrite(header, 1, RECORD_FRAME, r->file);
+    fwrite(r->buffer, 1, size, r->file);
+
+    memcpy(r->previous, cells, count * sizeof(uint64_t));
+
+    r->written = 1;
+    r->generation = generation;
+    r->since = key ? 0 : r->since + 1;
+
+    r->frames++;
+    r->bytes += RECORD_FRAME + size;
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Writer thread. Writes the generations pushed, in order, until the log is closed.
+*/
+static void* _Record_main(void* arg) {
+
+    Record_t r = (Record_t) arg;
+
+    uint64_t* cells = NULL;
+    size_t generation = 0;
+
+    while (1) {
+
+        pthread_mutex_lock(&r->lock);
+
+        while ((r->count == 0) && !r->quit) {
+            pthread_cond_wait(&r->wake, &r->lock);
+        }
+
+        if (r->count == 0) {
+
+            pthread_mutex_unlock(&r->lock);
+
+            break ;
+        }
+
+        cells = r->slots[r->head];
+        generation = r->generations[r->head];
+
+        pthread_mutex_unlock(&r->lock);
+
+        _Record_write(r, cells, generation);
+
+        pthread_mutex_lock(&r->lock);
+
+        r->head = (r->head + 1) % RECORD_SLOTS;
+        r->count--;
+
+        pthread_mutex_unlock(&r->lock);
+    }
+
+    return NULL;
+}
+
+/* ================================ */
+
+static void _Record_free(Record_t r) {
+
+    size_t i = 0;
+
+    if (r->file != NULL) {
+        fclose(r->file);
+    }
+
+    for (i = 0; i < RECORD_SLOTS; i++) {
+        free(r->slots[i]);
+    }
+
+    free(r->previous);
+    free(r->buffer);
+    free(r->keys);
+    free(r);
+
+    return ;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+Record_t Record_new(const char* filename, size_t rows, size_t columns, size_t every) {
+
+    Record_t r = NULL;
+
+    unsigned char header[RECORD_HEADER] = {0};
+
+    size_t count = 0;
+    size_t i = 0;
+
+    if ((filename == NULL) || ((r = (Record_t) calloc(1, sizeof(struct record))) == NULL)) {
+        return NULL;
+    }
+
+    r->rows = rows;
+    r->columns = columns;
+    r->words = (columns + GRID_WORD - 1) / GRID_WORD;
+    r->every = (every > 0) ? every : 1;
+
+    /* An empty world still gets a word */
+    count = (rows * r->words > 0) ? rows * r->words : 1;
+
+    for (i = 0; i < RECORD_SLOTS; i++) {
+
+        if ((r->slots[i] = (uint64_t*) calloc(count, sizeof(uint64_t))) == NULL) {
+
+            _Record_free(r);
+
+            return NULL;
+        }
+    }
+
+    if (((r->previous = (uint64_t*) calloc(count, sizeof(uint64_t))) == NULL) || ((r->file = file_create(filename)) == NULL)) {
+
+        _Record_free(r);
+
+        return NULL;
+    }
+
+    memcpy(header, RECORD_MAGIC, 4);
+
+    Snapshot_put(header + 4, RECORD_VERSION, 4);
+    Snapshot_put(header + 8, rows, 8);
+    Snapshot_put(header + 16, columns, 8);
+    Snapshot_put(header + 24, r->words, 8);
+
+    fwrite(header, 1, RECORD_HEADER, r->file);
+
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->wake, NULL);
+
+    if (pthread_create(&r->thread, NULL, _Record_main, r) != 0) {
+
+        pthread_mutex_destroy(&r->lock);
+        pthread_cond_destroy(&r->wake);
+
+        _Record_free(r);
+
+        return NULL;
+    }
+
+    return r;
+}
+
+/* ================================================================ */
+
+void Record_push(Record_t r, const Grid_t g, size_t generation) {
+
+    uint64_t* cells = NULL;
+
+    size_t slot = 0;
+    size_t row = 0;
+    size_t word = 0;
+
+    if ((r == NULL) || (g == NULL) || (g->rows != r->rows) || (g->columns != r->columns)) {
+        return ;
+    }
+
+    if (r->pushed && (generation >= r->last) && (generation - r->last < r->every)) {
+        return ;
+    }
+
+    pthread_mutex_lock(&r->lock);
+
+    /* A later delta is taken against the last frame written, so nothing is lost but this generation */
+    if (r->count == RECORD_SLOTS) {
+
+        r->dropped++;
+
+        pthread_mutex_unlock(&r->lock);
+
+        return ;
+    }
+
+    slot = (r->head + r->count) % RECORD_SLOTS;
+
+    pthread_mutex_unlock(&r->lock);
+
+    /* The writer does not look at free slots, so this one is filled without the lock */
+    cells = r->slots[slot];
+
+    for (row = 0; row < g->rows; row++) {
+
+        if (g->format == GRID_BITS) {
+
+            memcpy(cells + row * r->words, Grid_row(g, row), r->words * sizeof(uint64_t));
+
+            continue ;
+        }
+
+        for (word = 0; word < r->words; word++) {
+            cells[row * r->words + word] = Grid_word(g, row, word);
+        }
+    }
+
+    pthread_mutex_lock(&r->lock);
+
+    r->generations[slot] = generation;
+    r->count++;
+
+    pthread_cond_signal(&r->wake);
+    pthread_mutex_unlock(&r->lock);
+
+    r->pushed = 1;
+    r->last = generation;
+
+    return ;
+}
+
+/* ================================================================ */
+
+int Record_seek(const char* filename, size_t generation, Grid_t g, size_t* found) {
+
+    FILE* file = NULL;
+
+    unsigned char header[RECORD_HEADER];
+    unsigned char frame[RECORD_FRAME];
+    unsigned char trailer[RECORD_TRAILER];
+    unsigned char entry[16];
+
+    uint64_t* cells = NULL;
+    unsigned char* payload = NULL;
+    unsigned char* p = NULL;
+
+    size_t rows, words, count;
+
+    /* Frame to start reading from */
+    uint64_t start = RECORD_HEADER;
+    uint64_t index = 0;
+    uint64_t keys = 0;
+
+    uint64_t size = 0;
+    uint64_t capacity = 0;
+    uint64_t at = 0;
+
+    uint64_t w = 0;
+
+    size_t i = 0;
+    size_t row = 0;
+
+    int have = 0;
+
+    if ((filename == NULL) || (g == NULL) || ((file = fopen(filename, "rb")) == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    if ((fread(header, 1, RECORD_HEADER, file) != RECORD_HEADER) || (memcmp(header, RECORD_MAGIC, 4) != 0)) {
+
+        fclose(file);
+
+        return EXIT_FAILURE;
+    }
+
+    rows = Snapshot_get(header + 8, 8);
+    words = Snapshot_get(header + 24, 8);
+
+    count = (rows * words > 0) ? rows * words : 1;
+
+    if ((cells = (uint64_t*) calloc(count, sizeof(uint64_t))) == NULL) {
+
+        fclose(file);
+
+        return EXIT_FAILURE;
+    }
+
+    /* A log closed properly ends with an index of its keyframes: start from the last one not after `generation` */
+    if ((fseek(file, -RECORD_TRAILER, SEEK_END) == 0) && (fread(trailer, 1, RECORD_TRAILER, file) == RECORD_TRAILER) && (memcmp(trailer + 16, RECORD_INDEX, 4) == 0)) {
+
+        index = Snapshot_get(trailer, 8);
+        keys = Snapshot_get(trailer + 8, 8);
+
+        fseek(file, (long) index + 1, SEEK_SET);
+
+        for (i = 0; (i < keys) && (fread(entry, 1, 16, file) == 16) && (Snapshot_get(entry, 8) <= generation); i++) {
+            start = Snapshot_get(entry + 8, 8);
+        }
+    }
+
+    fseek(file, (long) start, SEEK_SET);
+
+    while ((fread(frame, 1, RECORD_FRAME, file) == RECORD_FRAME) && ((frame[0] == RECORD_KEY) || (frame[0] == RECORD_DELTA))) {
+
+        if (Snapshot_get(frame + 1, 8) > generation) {
+            break ;
+        }
+
+        size = Snapshot_get(frame + 9, 8);
+
+        if (size > capacity) {
+
+            if ((p = (unsigned char*) realloc(payload, size)) == NULL) {
+                break ;
+            }
+
+            payload = p;
+            capacity = size;
+        }
+
+        /* A log that was not closed properly may end with half a frame */
+        if (fread(payload, 1, size, file) != size) {
+            break ;
+        }
+
+        /* Deltas only make sense after a keyframe */
+        if (frame[0] == RECORD_KEY) {
+
+            memset(cells, 0, count * sizeof(uint64_t));
+
+            have = 1;
+        }
+
+        if (have) {
+
+            _Record_decode(payload, size, cells, rows * words);
+
+            at = Snapshot_get(frame + 1, 8);
+        }
+    }
+
+    fclose(file);
+    free(payload);
+
+    if (have) {
+
+        Grid_clear(g, 0);
+
+        for (row = 0; (row < rows) && (row < g->rows); row++) {
+
+            for (i = 0; i < words; i++) {
+
+                for (w = cells[row * words + i]; w; w &= w - 1) {
+
+                    if (i * GRID_WORD + __builtin_ctzll(w) < g->columns) {
+                        Grid_set(g, row, i * GRID_WORD + __builtin_ctzll(w), 1);
+                    }
+                }
+            }
+        }
+
+        if (found != NULL) {
+            *found = at;
+        }
+    }
+
+    free(cells);
+
+    return (have) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ================================================================ */
+
+void Record_log(const Record_t r) {
+
+    if (r == NULL) {
+        return ;
+    }
+
+    printf("%-16s: %ld frames (%ld keyframes), %.1f MiB\n", "recorded", r->frames, r->nkeys, r->bytes / 1048576.0);
+    printf("%-16s: %ld\n", "not recorded", r->dropped);
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Record_destroy(Record_t* r) {
+
+    unsigned char trailer[RECORD_TRAILER];
+    unsigned char entry[16];
+
+    long index = 0;
+
+    size_t i = 0;
+
+    if ((r == NULL) || (*r == NULL)) {
+        return ;
+    }
+
+    pthread_mutex_lock(&(*r)->lock);
+
+    (*r)->quit = 1;
+
+    pthread_cond_signal(&(*r)->wake);
+    pthread_mutex_unlock(&(*r)->lock);
+
+    /* The writer empties the slots before it leaves */
+    pthread_join((*r)->thread, NULL);
+
+    index = ftell((*r)->file);
+
+    putc(RECORD_END, (*r)->file);
+
+    for (i = 0; i < (*r)->nkeys; i++) {
+
+        Snapshot_put(entry, (*r)->keys[2 * i], 8);
+        Snapshot_put(entry + 8, (*r)->keys[2 * i + 1], 8);
+
+        fwrite(entry, 1, 16, (*r)->file);
+    }
+
+    Snapshot_put(trailer, (uint64_t) index, 8);
+    Snapshot_put(trailer + 8, (*r)->nkeys, 8);
+
+    memcpy(trailer + 16, RECORD_INDEX, 4);
+
+    fwrite(trailer, 1, RECORD_TRAILER, (*r)->file);
+
+    pthread_mutex_destroy(&(*r)->lock);
+    pthread_cond_destroy(&(*r)->wake);
+
+    _Record_free(*r);
+
+    *r = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
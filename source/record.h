@@ -0,0 +1,114 @@
+#ifndef GOL_RECORD_H
+#define GOL_RECORD_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define RECORD_MAGIC "GOLR"     /* First bytes of every log */
+#define RECORD_INDEX "GOLI"     /* Last bytes of a log closed properly */
+#define RECORD_VERSION 1
+
+#define RECORD_HEADER 32        /* magic (4 bytes), version (4), rows (8), columns (8), words per row (8) */
+#define RECORD_FRAME 17         /* kind (1 byte), generation (8), payload size (8) */
+#define RECORD_TRAILER 20       /* offset of the index (8), number of keyframes (8), magic (4) */
+
+#define RECORD_KEY 'K'          /* A frame holding the cells of a generation */
+#define RECORD_DELTA 'D'        /* A frame holding the cells that changed since the previous frame */
+#define RECORD_END 'I'          /* Marks the start of the index: (generation, offset) of every keyframe, 8 bytes each */
+
+#define RECORD_SLOTS 4          /* Number of generations waiting for the writer at most */
+#define RECORD_KEYFRAME 64      /* Number of frames between keyframes */
+
+/* ================================================================ */
+
+/**
+ * A log of generations written by a background thread.
+ * A frame payload is a run-length encoding of bit-packed rows, as in an RLE snapshot: LEB128 lengths of alternating runs of 0 and 1 bits.
+ * Every number in the file is little-endian.
+*/
+struct record {
+
+    FILE* file;
+
+    size_t rows;
+    size_t columns;
+    size_t words;               /* Number of words of a bit-packed row */
+
+    size_t every;               /* Record every `every`-th generation */
+
+    uint64_t* slots[RECORD_SLOTS];          /* Generations pushed and not yet written */
+    size_t generations[RECORD_SLOTS];
+    size_t head;                /* First slot waiting */
+    size_t count;               /* Number of slots waiting */
+
+    int pushed;                 /* Set once the first generation is pushed */
+    size_t last;                /* Last generation pushed */
+
+    uint64_t* previous;         /* Last generation written. Owned by the writer */
+    int written;                /* Set once the first frame is written */
+    size_t generation;          /* Generation of `previous` */
+    size_t since;               /* Number of frames since the last keyframe */
+
+    unsigned char* buffer;      /* Encoded payload of a frame. Owned by the writer */
+    size_t capacity;
+
+    uint64_t* keys;             /* Generation and offset of every keyframe */
+    size_t nkeys;
+    size_t kcapacity;
+
+    size_t frames;              /* Number of frames written */
+    size_t dropped;             /* Number of generations not recorded because the writer was behind */
+    size_t bytes;               /* Number of bytes written */
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        /* Signalled when a generation is pushed or the log is being closed */
+
+    int quit;
+};
+
+typedef struct record Record;
+
+typedef Record* Record_t;
+
+/* ================================================================ */
+
+/**
+ * Start a log of a world of size rows * columns, recording every `every`-th generation.
+*/
+extern Record_t Record_new(const char* filename, size_t rows, size_t columns, size_t every);
+
+/* ================================================================ */
+
+/**
+ * Hand the generation held by `g` over to the writer. Never waits for the disk:
+ * if the writer is behind, the generation is dropped and the next one recorded is a keyframe.
+*/
+extern void Record_push(Record_t r, const Grid_t g, size_t generation);
+
+/* ================================================================ */
+
+/**
+ * Rebuild the last recorded generation not after `generation` into `g` and return its number through `found`.
+ * A log that was not closed properly is read up to its last complete frame.
+*/
+extern int Record_seek(const char* filename, size_t generation, Grid_t g, size_t* found);
+
+/* ================================================================ */
+
+/**
+ * Print how much has been recorded.
+*/
+extern void Record_log(const Record_t r);
+
+/* ================================================================ */
+
+/**
+ * Write the generations still waiting and the index, close the log and set the pointer to NULL.
+*/
+extern void Record_destroy(Record_t* r);
+
+/* ================================================================ */
+
+#endif /* GOL_RECORD_H */
@@ -0,0 +1,298 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/**
+ * Read the digits of `s` into a mask of neighbour counts. Returns the position of the first character that is not a digit,
+ * or NULL if a digit is out of range or appears twice.
+*/
+static const char* _Rule_counts(const char* s, unsigned* mask) {
+
+    *mask = 0;
+
+    for (; isdigit((unsigned char) *s); s++) {
+
+        if ((*s == '9') || (*mask & (1u << (*s - '0')))) {
+            return NULL;
+        }
+
+        *mask |= 1u << (*s - '0');
+    }
+
+    return s;
+}
+
+/* ================================ */
+
+/**
+ * Read a decimal number no larger than `max`. Returns the position of the first character after it, or NULL if there is none or it is too large.
+*/
+static const char* _Rule_number(const char* s, unsigned max, unsigned* n) {
+
+    unsigned long v = 0;
+
+    if (!isdigit((unsigned char) *s)) {
+        return NULL;
+    }
+
+    for (; isdigit((unsigned char) *s); s++) {
+
+        if ((v = 10 * v + (unsigned long) (*s - '0')) > max) {
+            return NULL;
+        }
+    }
+
+    *n = (unsigned) v;
+
+    return s;
+}
+
+/* ================================ */
+
+/**
+ * Write the counts of `mask` after `letter`.
+*/
+static char* _Rule_name(char* name, char letter, unsigned mask) {
+
+    unsigned n = 0;
+
+    *name++ = letter;
+
+    for (n = 0; n <= 8; n++) {
+
+        if (mask & (1u << n)) {
+            *name++ = (char) ('0' + n);
+        }
+    }
+
+    return name;
+}
+
+/* ================================ */
+
+/**
+ * Parse a life-like or a Generations rulestring: two parts of counts, then the number of states.
+*/
+static int _Rule_parse_life(Rule* r, const char* s) {
+
+    unsigned masks[2] = {0, 0};
+
+    /* Whether the birth and the survival counts were given */
+    int given[2] = {0, 0};
+
+    /* Index of the counts being read: 0 - birth, 1 - survival */
+    int which = 1;
+
+    int part = 0;
+
+    /* Two parts separated by a slash, each one either lettered or, in the S/B notation, not */
+    for (part = 0; part < 2; part++) {
+
+        if ((*s == 'B') || (*s == 'b')) {
+            which = 0;
+            s++;
+        }
+        else if ((*s == 'S') || (*s == 's')) {
+            which = 1;
+            s++;
+        }
+        /* Without a letter, the survival counts come first, or the part is the other one */
+        else if (isdigit((unsigned char) *s) || (*s == '/') || (*s == '\0')) {
+            which = (part == 0) ? 1 : !which;
+        }
+        else {
+            return EXIT_FAILURE;
+        }
+
+        if (given[which] || ((s = _Rule_counts(s, &masks[which])) == NULL)) {
+            return EXIT_FAILURE;
+        }
+
+        given[which] = 1;
+
+        if ((part == 0) && (*s++ != '/')) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Generations: the number of states, lettered or not */
+    if (*s == '/') {
+
+        s++;
+
+        if ((*s == 'C') || (*s == 'c') || (*s == 'G') || (*s == 'g')) {
+            s++;
+        }
+
+        if (((s = _Rule_number(s, RULE_STATES, &r->states)) == NULL) || (r->states < 2)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (*s != '\0') {
+        return EXIT_FAILURE;
+    }
+
+    r->born = masks[0];
+    r->survives = masks[1];
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Parse a Larger than Life rulestring: comma-separated fields, each one a letter and its value.
+*/
+static int _Rule_parse_larger(Rule* r, const char* s) {
+
+    /* Whether the range, the survival and the birth counts were given */
+    int range = 0;
+    int survives = 0;
+    int born = 0;
+
+    unsigned middle = 0;
+
+    unsigned n = 0;
+
+    /* Largest count of a neighbourhood */
+    unsigned most = 0;
+
+    for (;;) {
+
+        switch (toupper((unsigned char) *s++)) {
+
+            case 'R':
+                s = _Rule_number(s, RULE_RANGE, &r->range);
+                range = 1;
+
+                break ;
+
+            /* 0 and 1 are other names of two states */
+            case 'C':
+                s = _Rule_number(s, RULE_STATES, &r->states);
+
+                if ((s != NULL) && (r->states < 2)) {
+                    r->states = 2;
+                }
+
+                break ;
+
+            case 'M':
+                s = _Rule_number(s, 1, &middle);
+                r->middle = (int) middle;
+
+                break ;
+
+            case 'S':
+                s = ((s = _Rule_number(s, UINT16_MAX, &r->survives_min)) != NULL) && (strncmp(s, "..", 2) == 0) ? _Rule_number(s + 2, UINT16_MAX, &r->survives_max) : NULL;
+                survives = 1;
+
+                break ;
+
+            case 'B':
+                s = ((s = _Rule_number(s, UINT16_MAX, &r->born_min)) != NULL) && (strncmp(s, "..", 2) == 0) ? _Rule_number(s + 2, UINT16_MAX, &r->born_max) : NULL;
+                born = 1;
+
+                break ;
+
+            /* The von Neumann neighbourhood is not supported */
+            case 'N':
+                s = ((*s == 'M') || (*s == 'm')) ? s + 1 : NULL;
+
+                break ;
+
+            default:
+                return EXIT_FAILURE;
+        }
+
+        if (s == NULL) {
+            return EXIT_FAILURE;
+        }
+
+        if (*s == '\0') {
+            break ;
+        }
+
+        if (*s++ != ',') {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!range || !survives || !born || (r->range == 0)) {
+        return EXIT_FAILURE;
+    }
+
+    /* Range 1 is a life-like rule, counting the neighbours only */
+    if (r->range == 1) {
+
+        most = 8;
+
+        for (n = 0; n <= most; n++) {
+            r->born |= ((n >= r->born_min) && (n <= r->born_max)) << n;
+            r->survives |= ((n + middle >= r->survives_min) && (n + middle <= r->survives_max)) << n;
+        }
+
+        r->middle = 0;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+int Rule_parse(Rule* r, const char* s) {
+
+    Rule rule = {.states = 2, .range = 1};
+
+    char* name = NULL;
+
+    int size = 0;
+
+    if ((r == NULL) || (s == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    if ((((*s == 'R') || (*s == 'r')) ? _Rule_parse_larger(&rule, s) : _Rule_parse_life(&rule, s)) == EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    if (rule.range > 1) {
+
+        size = snprintf(rule.name, RULE_NAME, "R%u,C%u,M%d,S%u..%u,B%u..%u",
+            rule.range, (rule.states > 2) ? rule.states : 0, rule.middle, rule.survives_min, rule.survives_max, rule.born_min, rule.born_max);
+
+        if ((size < 0) || (size >= RULE_NAME)) {
+            return EXIT_FAILURE;
+        }
+    }
+    else {
+
+        name = _Rule_name(rule.name, 'B', rule.born);
+        *name++ = '/';
+        name = _Rule_name(name, 'S', rule.survives);
+
+        /* "/C255" is the longest suffix, well within the name */
+        if (rule.states > 2) {
+            name += sprintf(name, "/C%u", rule.states);
+        }
+
+        *name = '\0';
+    }
+
+    *r = rule;
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+int Rule_is_planar(const Rule* r) {
+    return (r != NULL) && (r->states == 2) && (r->range == 1) && !(r->born & 1);
+}
+
+/* ================================================================ */
@@ -0,0 +1,103 @@
+#ifndef GOL_RULE_H
+#define GOL_RULE_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define RULE_LIFE "B3/S23"      /* Conway's Game of Life, the rule of a world naming none */
+
+#define RULE_NAME 32            /* Size of the longest canonical rulestring, including the terminating 0. That of the rule field of a snapshot */
+
+#define RULE_STATES 255         /* Largest number of states, so that every state fits a byte cell */
+#define RULE_RANGE 64           /* Largest range of a Larger than Life neighbourhood. No larger than a tile, so a tile only depends on the tiles next to it */
+
+/* ================================================================ */
+
+/**
+ * A rule of the life family: whether a cell lives in the next generation depends only on its state and on its number of live neighbours.
+ * Range 1 rules are a table of 18 entries, held as two masks of 9 bits indexed by the number of neighbours.
+ * Larger than Life rules count the live cells of a square of side 2 * range + 1 and compare them with two intervals.
+ * Generations rules of either kind have more than two states: only cells in state 1 are alive, and a live cell that does not survive
+ * decays through the states 2 .. states - 1 before it dies.
+*/
+struct rule {
+
+    unsigned born;              /* Range 1: bit `n` is set if a dead cell with `n` live neighbours is born */
+    unsigned survives;          /* Range 1: bit `n` is set if a live cell with `n` live neighbours survives */
+
+    unsigned states;            /* Number of states. 2 - dead and alive */
+
+    unsigned range;             /* Radius of the neighbourhood. 1, or more for Larger than Life */
+    int middle;                 /* Larger than Life: whether a live cell counts itself among its neighbours */
+
+    unsigned born_min;          /* Larger than Life: counts giving birth to a dead cell ... */
+    unsigned born_max;
+    unsigned survives_min;      /* ... and counts letting a live cell survive */
+    unsigned survives_max;
+
+    char name[RULE_NAME];       /* Canonical rulestring, such as "B36/S23", "B2/S/C3" or "R5,C0,M1,S34..58,B34..45" */
+};
+
+typedef struct rule Rule;
+
+/* ================================================================ */
+
+/**
+ * State of a cell in the next generation under a rule of range 1, given its state `cell` and its number of live neighbours `count`.
+*/
+static inline unsigned char Rule_next(const Rule* r, unsigned char cell, unsigned count) {
+
+    if (cell == 0) {
+        return (r->born >> count) & 1;
+    }
+
+    if (cell == 1) {
+        return ((r->survives >> count) & 1) ? 1 : (unsigned char) (2 % r->states);
+    }
+
+    return (cell + 1u < r->states) ? cell + 1 : 0;
+}
+
+/* ================================================================ */
+
+/**
+ * State of a cell in the next generation under a Larger than Life rule, given its state `cell` and the number of live cells
+ * `count` in its neighbourhood, itself included if the rule counts the middle.
+*/
+static inline unsigned char Rule_larger(const Rule* r, unsigned char cell, unsigned count) {
+
+    if (cell == 0) {
+        return (count >= r->born_min) && (count <= r->born_max);
+    }
+
+    if (cell == 1) {
+        return ((count >= r->survives_min) && (count <= r->survives_max)) ? 1 : (unsigned char) (2 % r->states);
+    }
+
+    return (cell + 1u < r->states) ? cell + 1 : 0;
+}
+
+/* ================================================================ */
+
+/**
+ * Parse a rulestring into `r`. Accepts:
+ * - life-like rules in B/S notation ("B36/S23", in any case and order) and in the older S/B one ("23/36");
+ * - Generations rules, with the number of states as a third part ("B2/S/C3", "/2/3");
+ * - Larger than Life rules in the notation of Golly ("R5,C0,M1,S34..58,B34..45,NM"), with the Moore neighbourhood only.
+ * A Larger than Life rule of range 1 becomes the life-like rule it is.
+ * Returns EXIT_FAILURE, leaving `r` untouched, if the string is not a valid rule or its canonical name does not fit `RULE_NAME`.
+*/
+extern int Rule_parse(Rule* r, const char* s);
+
+/* ================================================================ */
+
+/**
+ * Check whether the unbounded planes (HashLife and the sparse engine) can evolve a rule: a two-state rule of range 1
+ * that never gives birth to cells without live neighbours, as the empty space around the pattern would be born too.
+*/
+extern int Rule_is_planar(const Rule* r);
+
+/* ================================================================ */
+
+#endif /* GOL_RULE_H */
@@ -1,5 +1,108 @@
 #include "include.h"
 
+/* Longest nap of the simulation thread, in seconds, so it notices requests in time */
+#define NAP 0.005
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/**
+ * A world evolved by its own thread while the window is drawn by the main one.
+*/
+struct simulation {
+
+    World_t world;
+
+    pthread_t thread;
+
+    pthread_mutex_t lock;       /* Held while the world is evolved or changed */
+
+    atomic_int quit;            /* Set to stop the thread */
+    atomic_int evolving;        /* Whether generations are evolved */
+    atomic_int refresh;         /* Set when the world changed outside of an evolution step, so the current generation is handed over again */
+};
+
+/* ================================ */
+
+/**
+ * Move the window over the plane of a sparse world, while the simulation thread, if any, is not evolving it.
+*/
+static void _World_pan(struct simulation* s, const World_t world, int64_t rows, int64_t columns) {
+
+    if (s == NULL) {
+
+        World_pan(world, rows, columns);
+
+        return ;
+    }
+
+    pthread_mutex_lock(&s->lock);
+
+    World_pan(world, rows, columns);
+
+    pthread_mutex_unlock(&s->lock);
+
+    atomic_store(&s->refresh, 1);
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Evolve the world at its rate and hand every generation over to the renderer.
+*/
+static void* _World_simulate(void* arg) {
+
+    struct simulation* s = (struct simulation*) arg;
+
+    const World_t world = s->world;
+
+    struct timespec nap = {0};
+
+    double seconds = 0;
+
+    while (!atomic_load(&s->quit)) {
+
+        Timer_tick(world->clock);
+
+        if (atomic_load(&s->evolving) && Timer_is_ready(world->clock)) {
+
+            Timer_reset(world->clock);
+
+            pthread_mutex_lock(&s->lock);
+
+            World_evolve(world);
+            Triple_publish(world->handoff, World_current(world), world->generation);
+
+            pthread_mutex_unlock(&s->lock);
+
+            continue ;
+        }
+
+        if (atomic_exchange(&s->refresh, 0)) {
+
+            pthread_mutex_lock(&s->lock);
+
+            Triple_publish(world->handoff, World_current(world), world->generation);
+
+            pthread_mutex_unlock(&s->lock);
+        }
+
+        /* Sleep through the rest of the step, but not so long as to keep a request waiting */
+        seconds = (atomic_load(&s->evolving) && (world->clock->time - world->clock->acc < NAP)) ? world->clock->time - world->clock->acc : NAP;
+
+        nap.tv_nsec = (long) (((seconds > 0) ? seconds : 0) * 1e9);
+
+        nanosleep(&nap, NULL);
+    }
+
+    return NULL;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
 /* ================================================================ */
 
 void World_run(const World_t world) {
@@ -7,6 +110,9 @@ void World_run(const World_t world) {
     SDL_Event e;
     int running = 1;
 
+    /* The simulation thread, or NULL if the world is evolved by the main loop */
+    struct simulation* simulation = NULL;
+
     char fps_b[32];
     Text_t fps_text = NULL;
 
@@ -29,11 +135,39 @@ void World_run(const World_t world) {
 
     Timer_set(delay, 3);
 
+    /* Generations are handed over to the main loop, which draws the latest one without waiting for the next */
+    if (((simulation = (struct simulation*) calloc(1, sizeof(struct simulation))) != NULL)
+        && ((world->handoff = Triple_new(world->rows, world->columns, World_current(world)->format)) != NULL)) {
+
+        simulation->world = world;
+
+        Triple_publish(world->handoff, World_current(world), world->generation);
+
+        pthread_mutex_init(&simulation->lock, NULL);
+
+        if (pthread_create(&simulation->thread, NULL, _World_simulate, simulation) != 0) {
+
+            pthread_mutex_destroy(&simulation->lock);
+
+            Triple_destroy(&world->handoff);
+        }
+    }
+
+    if (world->handoff == NULL) {
+
+        free(simulation);
+
+        simulation = NULL;
+    }
+
     while (running) {
         Timer_tick(g_timer);
-        Timer_tick(world->clock);
         Timer_tick(delay);
 
+        if (simulation == NULL) {
+            Timer_tick(world->clock);
+        }
+
         while (SDL_PollEvent(&e)) {
 
             switch (e.type) {
@@ -42,6 +176,49 @@ void World_run(const World_t world) {
 
                     running = !running;
 
+                    break ;
+
+                /* Target textures lost their contents */
+                case SDL_RENDER_TARGETS_RESET:
+
+                case SDL_RENDER_DEVICE_RESET:
+
+                    Overlay_reset(world->overlay);
+
+                    break ;
+
+                /* Arrows move the window over the plane of a sparse world by a quarter of its size */
+                case SDL_KEYDOWN:
+
+                    switch (e.key.keysym.sym) {
+
+                        case SDLK_UP:
+                            _World_pan(simulation, world, -(int64_t) world->rows / 4, 0);
+
+                            break ;
+
+                        case SDLK_DOWN:
+                            _World_pan(simulation, world, (int64_t) world->rows / 4, 0);
+
+                            break ;
+
+                        case SDLK_LEFT:
+                            _World_pan(simulation, world, 0, -(int64_t) world->columns / 4);
+
+                            break ;
+
+                        case SDLK_RIGHT:
+                            _World_pan(simulation, world, 0, (int64_t) world->columns / 4);
+
+                            break ;
+
+                        /* R switches to the next renderer, so they can be compared on the same world */
+                        case SDLK_r:
+                            world->renderer = (world->renderer + 1) % RENDERERS;
+
+                            break ;
+                    }
+
                     break ;
             }
         }
@@ -58,15 +235,12 @@ void World_run(const World_t world) {
 
             /* ========================= Grid drawing ========================= */
             if (world->is_grid) {
-
-                LilEn_set_colorRGB(world->g_color[0], world->g_color[1], world->g_color[2], world->g_color[3]);
-
-                Window_display_grid(NULL, world->cell_size);
+                World_present_grid(world, NULL);
             }
 
             /* ======================== Text updating ========================= */
             sprintf(fps_b, "fps: %.1f", 1.0f / g_timer->acc);
-            sprintf(generation_b, "gen: %ld", world->generation);
+            sprintf(generation_b, "gen: %ld", world->shown);
 
             LilEn_set_colorRGB(world->text_color[0], world->text_color[1], world->text_color[2], world->text_color[3]);
             Text_update(fps_text, fps_b, font);
@@ -87,7 +261,10 @@ void World_run(const World_t world) {
             Timer_reset(g_timer);
         }
 
-        if (start) {
+        if (simulation != NULL) {
+            atomic_store(&simulation->evolving, start);
+        }
+        else if (start) {
 
             if (Timer_is_ready(world->clock)) {
 
@@ -102,9 +279,25 @@ void World_run(const World_t world) {
         }
     }
 
+    if (simulation != NULL) {
+
+        atomic_store(&simulation->quit, 1);
+
+        pthread_join(simulation->thread, NULL);
+        pthread_mutex_destroy(&simulation->lock);
+
+        free(simulation);
+    }
+
+    Triple_destroy(&world->handoff);
+
     Text_destroy(&fps_text);
     Text_destroy(&generation_text);
 
+    /* Textures go with the renderer */
+    View_destroy(&world->view);
+    Overlay_destroy(&world->overlay);
+
     Font_unload(font);
 
     return ;
@@ -112,6 +305,47 @@ void World_run(const World_t world) {
 
 /* ================================================================ */
 
+void World_run_headless(const World_t world, size_t generations) {
+
+    struct timespec start, end;
+
+    /* Generation to reach */
+    size_t last = world->generation + generations;
+
+    size_t previous = 0;
+
+    double seconds = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    /* A HashLife step may go past the last generation */
+    while (world->generation < last) {
+
+        previous = world->generation;
+
+        World_evolve(world);
+
+        /* The engine ran out of memory */
+        if (world->generation == previous) {
+            break ;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    generations = world->generation - (last - generations);
+
+    printf("%-16s: %ld in %.3f s\n", "generations", generations, seconds);
+    printf("%-16s: %.1f\n", "generations/s", (seconds > 0) ? generations / seconds : 0);
+    printf("%-16s: %.3g\n", "cells/s", (seconds > 0) ? (double) generations * world->rows * world->columns / seconds : 0);
+
+    return ;
+}
+
+/* ================================================================ */
+
 void World_edit(const World_t world) {
 
     SDL_Event e;
@@ -132,6 +366,14 @@ void World_edit(const World_t world) {
 
                     break ;
 
+                case SDL_RENDER_TARGETS_RESET:
+
+                case SDL_RENDER_DEVICE_RESET:
+
+                    Overlay_reset(world->overlay);
+
+                    break ;
+
                 case SDL_MOUSEMOTION:
 
                     SDL_GetMouseState(&rect.x, &rect.y);
@@ -144,7 +386,13 @@ void World_edit(const World_t world) {
                 case SDL_MOUSEBUTTONDOWN:
 
                     if (e.button.button == SDL_BUTTON_LEFT) {
-                        world->current[rect.y / rect.h][rect.x / rect.w] = !world->current[rect.y / rect.h][rect.x / rect.w];
+                        Grid_toggle(World_current(world), rect.y / rect.h, rect.x / rect.w);
+
+                        Tiles_touch(world->tiles, rect.y / rect.h, rect.x / rect.w);
+
+                        Quad_set(world->quad, rect.y / rect.h, rect.x / rect.w, Grid_get(World_current(world), rect.y / rect.h, rect.x / rect.w));
+
+                        Sparse_set(world->sparse, world->top + rect.y / rect.h, world->left + rect.x / rect.w, Grid_get(World_current(world), rect.y / rect.h, rect.x / rect.w));
                     }
 
                     break ;
@@ -167,10 +415,7 @@ void World_edit(const World_t world) {
 
             /* ========================= Grid drawing ========================= */
             if (world->is_grid) {
-
-                LilEn_set_colorRGB(world->g_color[0], world->g_color[1], world->g_color[2], world->g_color[3]);
-
-                Window_display_grid(NULL, world->cell_size);
+                World_present_grid(world, NULL);
             }
 
             /* ======================== Window update ========================= */
@@ -180,5 +425,9 @@ void World_edit(const World_t world) {
         }
     }
 
+    /* Textures go with the renderer */
+    View_destroy(&world->view);
+    Overlay_destroy(&world->overlay);
+
     return ;
 }
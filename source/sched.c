@@ -0,0 +1,240 @@
+#include "include.h"
+
+/* Returned by `_Sched_pop` and `_Sched_steal` when a deque is empty */
+#define NONE SIZE_MAX
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+static double _Sched_now(void) {
+
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* ================================ */
+
+/**
+ * Take a tile from the front of a deque.
+*/
+static size_t _Sched_pop(const Sched_t s, struct deque* d) {
+
+    uint64_t range = atomic_load(&d->range);
+
+    while ((range >> 32) < (range & UINT32_MAX)) {
+
+        if (atomic_compare_exchange_weak(&d->range, &range, range + (UINT64_C(1) << 32))) {
+            return s->order[range >> 32];
+        }
+    }
+
+    return NONE;
+}
+
+/* ================================ */
+
+/**
+ * Take a tile from the back of a deque.
+*/
+static size_t _Sched_steal(const Sched_t s, struct deque* d) {
+
+    uint64_t range = atomic_load(&d->range);
+
+    while ((range >> 32) < (range & UINT32_MAX)) {
+
+        if (atomic_compare_exchange_weak(&d->range, &range, range - 1)) {
+            return s->order[(range & UINT32_MAX) - 1];
+        }
+    }
+
+    return NONE;
+}
+
+/* ================================ */
+
+/**
+ * Evolve a single tile and remember whether it has changed.
+*/
+static void _Sched_tile(const Sched_t s, struct deque* d, size_t tile) {
+
+    size_t top, bottom, left, right;
+
+    double start = _Sched_now();
+
+    Tiles_region(s->tiles, tile, &top, &bottom, &left, &right);
+
+    s->kernel(s->next, s->prev, s->rule, top, bottom, left, right);
+
+    s->tiles->changing[tile] = !Grid_equal(s->next, s->prev, top, bottom, left, right);
+
+    d->busy += _Sched_now() - start;
+    d->tiles++;
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Work through the own deque, then help the other threads with theirs.
+*/
+static void _Sched_work(void* arg, size_t index, size_t size) {
+
+    const Sched_t s = (Sched_t) arg;
+
+    struct deque* own = &s->deques[index];
+
+    size_t tile = 0;
+    size_t i = 0;
+
+    while ((tile = _Sched_pop(s, own)) != NONE) {
+        _Sched_tile(s, own, tile);
+    }
+
+    for (i = 1; i < size; i++) {
+
+        while ((tile = _Sched_steal(s, &s->deques[(index + i) % size])) != NONE) {
+
+            _Sched_tile(s, own, tile);
+
+            own->stolen++;
+        }
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+Sched_t Sched_new(const Tiles_t t, size_t threads) {
+
+    Sched_t s = NULL;
+
+    if ((t == NULL) || (threads == 0)) {
+        return NULL;
+    }
+
+    if ((s = (Sched_t) calloc(1, sizeof(struct sched))) == NULL) {
+        return NULL;
+    }
+
+    s->threads = threads;
+
+    /* Deques are aligned to cache lines, so threads never write to the same line */
+    if (((s->order = (size_t*) calloc(Tiles_count(t), sizeof(size_t))) == NULL)
+        || ((s->deques = (struct deque*) aligned_alloc(GRID_ALIGN, threads * sizeof(struct deque))) == NULL)) {
+
+        Sched_destroy(&s);
+
+        return NULL;
+    }
+
+    memset(s->deques, 0, threads * sizeof(struct deque));
+
+    return s;
+}
+
+/* ================================================================ */
+
+void Sched_run(Sched_t s, Tiles_t t, Pool_t pool, Kernel_t kernel, const Rule* rule, Grid_t next, const Grid_t prev) {
+
+    size_t tile = 0;
+
+    /* Number of tiles queued */
+    size_t queued = 0;
+
+    /* Number of threads taking part */
+    size_t size = 0;
+
+    size_t i = 0;
+
+    if ((s == NULL) || (t == NULL) || (kernel == NULL) || (rule == NULL)) {
+        return ;
+    }
+
+    size = (pool != NULL) ? pool->size : 1;
+
+    if (size > s->threads) {
+        size = s->threads;
+    }
+
+    /* Only tiles next to a change can change themselves */
+    for (tile = 0; tile < Tiles_count(t); tile++) {
+
+        if (Tiles_dirty(t, tile)) {
+            s->order[queued++] = tile;
+        }
+    }
+
+    s->skipped += Tiles_count(t) - queued;
+
+    Tiles_begin(t);
+
+    /* Every thread starts with a contiguous run of tiles */
+    for (i = 0; i < size; i++) {
+        atomic_store(&s->deques[i].range, ((uint64_t) (queued * i / size) << 32) | (uint64_t) (queued * (i + 1) / size));
+    }
+
+    s->kernel = kernel;
+    s->rule = rule;
+    s->tiles = t;
+    s->next = next;
+    s->prev = prev;
+
+    if ((pool != NULL) && (size > 1)) {
+        Pool_run(pool, _Sched_work, s);
+    }
+    else {
+        _Sched_work(s, 0, 1);
+    }
+
+    Tiles_end(t);
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Sched_log(const Sched_t s) {
+
+    size_t i = 0;
+
+    if (s == NULL) {
+        return ;
+    }
+
+    printf("%-16s: %ld\n", "tiles skipped", s->skipped);
+
+    for (i = 0; i < s->threads; i++) {
+        printf("%-16s: %ld busy %.3f s, %ld tiles (%ld stolen)\n", "thread", i, s->deques[i].busy, s->deques[i].tiles, s->deques[i].stolen);
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Sched_destroy(Sched_t* s) {
+
+    if ((s == NULL) || (*s == NULL)) {
+        return ;
+    }
+
+    free((*s)->order);
+    free((*s)->deques);
+    free(*s);
+
+    *s = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
+
+#undef NONE
@@ -0,0 +1,73 @@
+#ifndef GOL_SCHED_H
+#define GOL_SCHED_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+/**
+ * Tiles queued for a single thread. Owners take tiles from the front, thieves from the back.
+*/
+struct deque {
+
+    _Alignas(GRID_ALIGN) _Atomic uint64_t range;   /* Queued entries of `order`: the first one in the upper 32 bits, one past the last in the lower 32 bits */
+
+    double busy;        /* Seconds spent evolving tiles */
+    size_t tiles;       /* Number of tiles evolved */
+    size_t stolen;      /* Number of tiles taken from other threads */
+};
+
+/* ================================ */
+
+struct sched {
+
+    size_t* order;              /* Tiles to evolve during the current step */
+
+    size_t threads;             /* Number of deques */
+    struct deque* deques;
+
+    size_t skipped;             /* Number of stable tiles skipped so far */
+
+    Kernel_t kernel;            /* Kernel of the current step */
+    const Rule* rule;           /* Rule of the current step */
+    Tiles_t tiles;              /* Tiles of the current step */
+    Grid_t next;                /* Grids of the current step */
+    Grid_t prev;
+};
+
+typedef struct sched Sched;
+
+typedef Sched* Sched_t;
+
+/* ================================================================ */
+
+/**
+ * Create a scheduler able to queue the tiles `t` on `threads` threads.
+*/
+extern Sched_t Sched_new(const Tiles_t t, size_t threads);
+
+/* ================================================================ */
+
+/**
+ * Evolve `prev` into `next` under `rule` with `kernel` on the threads of `pool` (or on the calling thread only if `pool` is NULL).
+ * Only dirty tiles of `t` are evolved, and the tiles changed by the step are recorded in `t`.
+*/
+extern void Sched_run(Sched_t s, Tiles_t t, Pool_t pool, Kernel_t kernel, const Rule* rule, Grid_t next, const Grid_t prev);
+
+/* ================================================================ */
+
+/**
+ * Print how much work every thread has done.
+*/
+extern void Sched_log(const Sched_t s);
+
+/* ================================================================ */
+
+/**
+ * Deallocate a scheduler and set the pointer to NULL.
+*/
+extern void Sched_destroy(Sched_t* s);
+
+/* ================================================================ */
+
+#endif /* GOL_SCHED_H */
@@ -0,0 +1,378 @@
+#include "include.h"
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/**
+ * Get the three rows of `prev` needed to evolve the row `row`. Above the top and below the bottom lie the opposite edge or the halo.
+*/
+static void _Simd_rows(const Grid_t prev, size_t row, const unsigned char** up, const unsigned char** mid, const unsigned char** down) {
+
+    *up = (const unsigned char*) Grid_above(prev, row);
+    *mid = Grid_bytes(prev, row);
+    *down = (const unsigned char*) Grid_below(prev, row);
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Evolve a single cell of `g`. Across the left and the right edges lies the opposite column, or what lies beyond a bounded grid.
+*/
+static unsigned char _Simd_cell(const Grid_t g, const Rule* rule, const unsigned char* up, const unsigned char* mid, const unsigned char* down, size_t column) {
+
+    const size_t columns = g->columns;
+
+    /* Neighbours in the columns to the west and to the east */
+    unsigned char west = 0;
+    unsigned char east = 0;
+
+    if (column > 0) {
+        west = up[column - 1] + mid[column - 1] + down[column - 1];
+    }
+    else {
+        west = (g->halo == NULL) ? up[columns - 1] + mid[columns - 1] + down[columns - 1] : 3 * Grid_beyond(g);
+    }
+
+    if (column + 1 < columns) {
+        east = up[column + 1] + mid[column + 1] + down[column + 1];
+    }
+    else {
+        east = (g->halo == NULL) ? up[0] + mid[0] + down[0] : 3 * Grid_beyond(g);
+    }
+
+    return Rule_next(rule, mid[column], west + up[column] + down[column] + east);
+}
+
+/* ================================ */
+
+/**
+ * Evolve the cells `from` .. `to - 1` one at a time. Used for the cells a vector loop cannot reach.
+*/
+static void _Simd_span(const Grid_t g, const Rule* rule, unsigned char* out, const unsigned char* up, const unsigned char* mid, const unsigned char* down, size_t from, size_t to) {
+
+    size_t column = 0;
+
+    for (column = from; column < to; column++) {
+        out[column] = _Simd_cell(g, rule, up, mid, down, column);
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Spread a mask of neighbour counts into a table of 16 bytes: byte `n` is the next state of a cell with `n` live neighbours.
+ * Vector kernels look the counts up in it with a byte shuffle.
+*/
+static void _Simd_table(unsigned char table[16], unsigned mask) {
+
+    unsigned n = 0;
+
+    for (n = 0; n < 16; n++) {
+        table[n] = (n <= 8) ? (mask >> n) & 1 : 0;
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+void Kernel_bytes(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right) {
+
+    size_t row = 0;
+
+    const unsigned char* up = NULL;
+    const unsigned char* mid = NULL;
+    const unsigned char* down = NULL;
+
+    if ((prev->rows == 0) || (prev->columns == 0)) {
+        return ;
+    }
+
+    for (row = top; row < bottom; row++) {
+
+        _Simd_rows(prev, row, &up, &mid, &down);
+        _Simd_span(prev, rule, Grid_bytes(next, row), up, mid, down, left, right);
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+
+#ifdef SIMD_X86
+
+__attribute__((target("sse2")))
+void Kernel_sse2(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right) {
+
+    size_t row = 0;
+    size_t column = 0;
+
+    /* Columns the vector loop may cover */
+    size_t first = 0;
+    size_t stop = 0;
+
+    const unsigned char* up = NULL;
+    const unsigned char* mid = NULL;
+    const unsigned char* down = NULL;
+
+    unsigned char* out = NULL;
+
+    const __m128i one = _mm_set1_epi8(1);
+
+    /* Counts giving birth and counts letting a cell survive. SSE2 has no byte shuffle, so counts are compared one by one */
+    __m128i births[9], survivals[9];
+    size_t born = 0;
+    size_t survives = 0;
+
+    size_t n = 0;
+
+    __m128i acc, alive, b, s;
+
+    if ((prev->rows == 0) || (prev->columns == 0) || (left >= right)) {
+        return ;
+    }
+
+    for (n = 0; n <= 8; n++) {
+
+        if ((rule->born >> n) & 1) {
+            births[born++] = _mm_set1_epi8((char) n);
+        }
+
+        if ((rule->survives >> n) & 1) {
+            survivals[survives++] = _mm_set1_epi8((char) n);
+        }
+    }
+
+    /* Vector lanes never wrap: they start after the first column and end before the last one */
+    first = (left > 0) ? left : 1;
+    stop = (right < prev->columns) ? right : prev->columns - 1;
+
+    for (row = top; row < bottom; row++) {
+
+        _Simd_rows(prev, row, &up, &mid, &down);
+        out = Grid_bytes(next, row);
+
+        _Simd_span(prev, rule, out, up, mid, down, left, first);
+
+        /* Every lane reads its neighbours with plain unaligned loads */
+        for (column = first; column + 16 <= stop; column += 16) {
+
+            acc = _mm_add_epi8(_mm_loadu_si128((const __m128i*) (up + column - 1)), _mm_loadu_si128((const __m128i*) (up + column)));
+            acc = _mm_add_epi8(acc, _mm_loadu_si128((const __m128i*) (up + column + 1)));
+            acc = _mm_add_epi8(acc, _mm_loadu_si128((const __m128i*) (mid + column - 1)));
+            acc = _mm_add_epi8(acc, _mm_loadu_si128((const __m128i*) (mid + column + 1)));
+            acc = _mm_add_epi8(acc, _mm_loadu_si128((const __m128i*) (down + column - 1)));
+            acc = _mm_add_epi8(acc, _mm_loadu_si128((const __m128i*) (down + column)));
+            acc = _mm_add_epi8(acc, _mm_loadu_si128((const __m128i*) (down + column + 1)));
+
+            alive = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (mid + column)), one);
+
+            b = _mm_setzero_si128();
+            s = _mm_setzero_si128();
+
+            for (n = 0; n < born; n++) {
+                b = _mm_or_si128(b, _mm_cmpeq_epi8(acc, births[n]));
+            }
+
+            for (n = 0; n < survives; n++) {
+                s = _mm_or_si128(s, _mm_cmpeq_epi8(acc, survivals[n]));
+            }
+
+            acc = _mm_or_si128(_mm_and_si128(alive, s), _mm_andnot_si128(alive, b));
+
+            _mm_storeu_si128((__m128i*) (out + column), _mm_and_si128(acc, one));
+        }
+
+        _Simd_span(prev, rule, out, up, mid, down, column, right);
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+
+__attribute__((target("avx2")))
+void Kernel_avx2(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right) {
+
+    size_t row = 0;
+    size_t column = 0;
+
+    /* Columns the vector loop may cover */
+    size_t first = 0;
+    size_t stop = 0;
+
+    const unsigned char* up = NULL;
+    const unsigned char* mid = NULL;
+    const unsigned char* down = NULL;
+
+    unsigned char* out = NULL;
+
+    const __m256i one = _mm256_set1_epi8(1);
+
+    /* Next state of a dead and of a live cell for every count, in both lanes */
+    unsigned char table[16];
+    __m256i born, survives;
+
+    __m256i acc, alive;
+
+    if ((prev->rows == 0) || (prev->columns == 0) || (left >= right)) {
+        return ;
+    }
+
+    _Simd_table(table, rule->born);
+    born = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) table));
+
+    _Simd_table(table, rule->survives);
+    survives = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) table));
+
+    /* Vector lanes never wrap: they start after the first column and end before the last one */
+    first = (left > 0) ? left : 1;
+    stop = (right < prev->columns) ? right : prev->columns - 1;
+
+    for (row = top; row < bottom; row++) {
+
+        _Simd_rows(prev, row, &up, &mid, &down);
+        out = Grid_bytes(next, row);
+
+        _Simd_span(prev, rule, out, up, mid, down, left, first);
+
+        for (column = first; column + 32 <= stop; column += 32) {
+
+            acc = _mm256_add_epi8(_mm256_loadu_si256((const __m256i*) (up + column - 1)), _mm256_loadu_si256((const __m256i*) (up + column)));
+            acc = _mm256_add_epi8(acc, _mm256_loadu_si256((const __m256i*) (up + column + 1)));
+            acc = _mm256_add_epi8(acc, _mm256_loadu_si256((const __m256i*) (mid + column - 1)));
+            acc = _mm256_add_epi8(acc, _mm256_loadu_si256((const __m256i*) (mid + column + 1)));
+            acc = _mm256_add_epi8(acc, _mm256_loadu_si256((const __m256i*) (down + column - 1)));
+            acc = _mm256_add_epi8(acc, _mm256_loadu_si256((const __m256i*) (down + column)));
+            acc = _mm256_add_epi8(acc, _mm256_loadu_si256((const __m256i*) (down + column + 1)));
+
+            alive = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) (mid + column)), one);
+
+            /* Counts are looked up in both tables, and the cell picks one */
+            acc = _mm256_blendv_epi8(_mm256_shuffle_epi8(born, acc), _mm256_shuffle_epi8(survives, acc), alive);
+
+            _mm256_storeu_si256((__m256i*) (out + column), acc);
+        }
+
+        _Simd_span(prev, rule, out, up, mid, down, column, right);
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+
+__attribute__((target("avx512f,avx512bw")))
+void Kernel_avx512(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right) {
+
+    size_t row = 0;
+    size_t column = 0;
+
+    /* Columns the vector loop may cover */
+    size_t first = 0;
+    size_t stop = 0;
+
+    const unsigned char* up = NULL;
+    const unsigned char* mid = NULL;
+    const unsigned char* down = NULL;
+
+    unsigned char* out = NULL;
+
+    const __m512i one = _mm512_set1_epi8(1);
+
+    /* Next state of a dead and of a live cell for every count, in every lane */
+    unsigned char table[16];
+    __m512i born, survives;
+
+    __m512i acc;
+    __mmask64 alive;
+
+    if ((prev->rows == 0) || (prev->columns == 0) || (left >= right)) {
+        return ;
+    }
+
+    _Simd_table(table, rule->born);
+    born = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*) table));
+
+    _Simd_table(table, rule->survives);
+    survives = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*) table));
+
+    /* Vector lanes never wrap: they start after the first column and end before the last one */
+    first = (left > 0) ? left : 1;
+    stop = (right < prev->columns) ? right : prev->columns - 1;
+
+    for (row = top; row < bottom; row++) {
+
+        _Simd_rows(prev, row, &up, &mid, &down);
+        out = Grid_bytes(next, row);
+
+        _Simd_span(prev, rule, out, up, mid, down, left, first);
+
+        for (column = first; column + 64 <= stop; column += 64) {
+
+            acc = _mm512_add_epi8(_mm512_loadu_si512(up + column - 1), _mm512_loadu_si512(up + column));
+            acc = _mm512_add_epi8(acc, _mm512_loadu_si512(up + column + 1));
+            acc = _mm512_add_epi8(acc, _mm512_loadu_si512(mid + column - 1));
+            acc = _mm512_add_epi8(acc, _mm512_loadu_si512(mid + column + 1));
+            acc = _mm512_add_epi8(acc, _mm512_loadu_si512(down + column - 1));
+            acc = _mm512_add_epi8(acc, _mm512_loadu_si512(down + column));
+            acc = _mm512_add_epi8(acc, _mm512_loadu_si512(down + column + 1));
+
+            alive = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(mid + column), one);
+
+            _mm512_storeu_si512(out + column, _mm512_mask_blend_epi8(alive, _mm512_shuffle_epi8(born, acc), _mm512_shuffle_epi8(survives, acc)));
+        }
+
+        _Simd_span(prev, rule, out, up, mid, down, column, right);
+    }
+
+    return ;
+}
+
+#endif /* SIMD_X86 */
+
+/* ================================================================ */
+
+Kernel_t Simd_select(void) {
+
+    static Kernel_t kernel = NULL;
+
+    if (kernel != NULL) {
+        return kernel;
+    }
+
+    kernel = Kernel_bytes;
+
+#ifdef SIMD_X86
+
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512bw")) {
+        kernel = Kernel_avx512;
+    }
+    else if (__builtin_cpu_supports("avx2")) {
+        kernel = Kernel_avx2;
+    }
+    else if (__builtin_cpu_supports("sse2")) {
+        kernel = Kernel_sse2;
+    }
+
+#endif
+
+    return kernel;
+}
+
+/* ================================================================ */
+
+#undef SIMD_X86
@@ -0,0 +1,41 @@
+#ifndef GOL_SIMD_H
+#define GOL_SIMD_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86                /* The x86 vector kernels are built */
+#endif
+
+/* ================================================================ */
+
+/**
+ * Portable byte-cell kernel. Used when the CPU offers none of the vector extensions below.
+*/
+extern void Kernel_bytes(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right);
+
+/* ================================================================ */
+
+/**
+ * Byte-cell kernels evolving 16 (SSE2), 32 (AVX2) or 64 (AVX-512BW) cells per instruction.
+ * AVX2 and AVX-512BW look the counts up in the rule with byte shuffles, so every rule runs as fast; SSE2 compares them to every count the rule names.
+ * Only defined on x86. Call them only on a CPU supporting the extension.
+*/
+extern void Kernel_sse2(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right);
+
+extern void Kernel_avx2(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right);
+
+extern void Kernel_avx512(Grid_t next, const Grid_t prev, const Rule* rule, size_t top, size_t bottom, size_t left, size_t right);
+
+/* ================================================================ */
+
+/**
+ * Pick the best byte-cell kernel for the running CPU. The choice is made once, on the first call.
+*/
+extern Kernel_t Simd_select(void);
+
+/* ================================================================ */
+
+#endif /* GOL_SIMD_H */
@@ -0,0 +1,660 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/* Size of the stdio buffer of a snapshot file */
+#define BUFFER (1 << 20)
+
+/* Words are stored little-endian, so on such a host the payload can be used as it is */
+#define NATIVE (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+
+/* Number of words of a `SNAPSHOT_LINES` row of `columns` cells. The same as a bit-packed grid has */
+#define LINES(columns) ((((columns) + GRID_WORD - 1) / GRID_WORD + 7) / 8 * 8)
+
+/* ================================ */
+
+static void _Snapshot_write_header(unsigned char* header, const Snapshot* s, uint32_t encoding, const Grid_t g) {
+
+    memset(header, 0, SNAPSHOT_HEADER);
+    memcpy(header, SNAPSHOT_MAGIC, 4);
+
+    Snapshot_put(header + 4, SNAPSHOT_VERSION, 4);
+    Snapshot_put(header + 8, encoding, 4);
+    Snapshot_put(header + 12, s->type, 4);
+    Snapshot_put(header + 16, g->rows, 8);
+    Snapshot_put(header + 24, g->columns, 8);
+    Snapshot_put(header + 32, s->generation, 8);
+
+    /* The field is zeroed above, so a rule of `SNAPSHOT_RULE - 1` characters still ends with a 0 */
+    memcpy(header + 40, s->rule, strnlen(s->rule, SNAPSHOT_RULE - 1));
+
+    return ;
+}
+
+/* ================================ */
+
+static int _Snapshot_read_header(const unsigned char* header, Snapshot* s) {
+
+    if (memcmp(header, SNAPSHOT_MAGIC, 4) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    s->version = (uint32_t) Snapshot_get(header + 4, 4);
+    s->encoding = (uint32_t) Snapshot_get(header + 8, 4);
+    s->type = (uint32_t) Snapshot_get(header + 12, 4);
+    s->rows = Snapshot_get(header + 16, 8);
+    s->columns = Snapshot_get(header + 24, 8);
+    s->generation = Snapshot_get(header + 32, 8);
+
+    memcpy(s->rule, header + 40, SNAPSHOT_RULE);
+    s->rule[SNAPSHOT_RULE - 1] = '\0';
+
+    /* Newer files may be laid out differently */
+    if ((s->version > SNAPSHOT_VERSION) || (s->encoding > SNAPSHOT_STATES)) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+static void _Snapshot_write_varint(FILE* file, uint64_t v) {
+
+    while (v >= 0x80) {
+
+        putc((int) (v & 0x7F) | 0x80, file);
+
+        v >>= 7;
+    }
+
+    putc((int) v, file);
+
+    return ;
+}
+
+/* ================================ */
+
+static int _Snapshot_read_varint(FILE* file, uint64_t* v) {
+
+    int c = 0;
+
+    unsigned shift = 0;
+
+    *v = 0;
+
+    do {
+
+        if (((c = getc(file)) == EOF) || (shift > 63)) {
+            return EXIT_FAILURE;
+        }
+
+        *v |= (uint64_t) (c & 0x7F) << shift;
+
+        shift += 7;
+
+    } while (c & 0x80);
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Write the cells as runs. Runs go on across rows.
+*/
+static void _Snapshot_write_rle(FILE* file, const Grid_t g) {
+
+    /* State and length of the current run */
+    int state = 0;
+    uint64_t run = 0;
+
+    size_t row = 0;
+    size_t word = 0;
+    size_t used = (g->columns + GRID_WORD - 1) / GRID_WORD;
+
+    /* Cells of the word not looked at yet */
+    uint64_t w = 0;
+    size_t n = 0;
+
+    /* Length of the part of `w` in the current state */
+    size_t k = 0;
+
+    for (row = 0; row < g->rows; row++) {
+
+        for (word = 0; word < used; word++) {
+
+            w = Grid_word(g, row, word);
+            n = (g->columns - word * GRID_WORD < GRID_WORD) ? g->columns - word * GRID_WORD : GRID_WORD;
+
+            while (n > 0) {
+
+                /* Find the first cell in the other state */
+                k = ((state ? ~w : w) != 0) ? (size_t) __builtin_ctzll(state ? ~w : w) : GRID_WORD;
+                k = (k < n) ? k : n;
+
+                run += k;
+                n -= k;
+                w = (k < GRID_WORD) ? w >> k : 0;
+
+                if (n > 0) {
+
+                    _Snapshot_write_varint(file, run);
+
+                    run = 0;
+                    state = !state;
+                }
+            }
+        }
+    }
+
+    if (run > 0) {
+        _Snapshot_write_varint(file, run);
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+static int _Snapshot_read_rle(FILE* file, const Snapshot* s, Grid_t g) {
+
+    int state = 0;
+    uint64_t run = 0;
+
+    /* Position of the first cell of the run, in row-major order */
+    uint64_t p = 0;
+    uint64_t i = 0;
+
+    uint64_t total = s->rows * s->columns;
+
+    while ((p < total) && (_Snapshot_read_varint(file, &run) == EXIT_SUCCESS)) {
+
+        run = (run < total - p) ? run : total - p;
+
+        for (i = p; state && (i < p + run); i++) {
+
+            if ((i / s->columns < g->rows) && (i % s->columns < g->columns)) {
+                Grid_set(g, i / s->columns, i % s->columns, 1);
+            }
+        }
+
+        p += run;
+        state = !state;
+    }
+
+    return (p == total) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* ================================ */
+
+/**
+ * Read rows of `stride` words, of which the first ones hold the cells.
+*/
+static int _Snapshot_read_bits(FILE* file, const Snapshot* s, Grid_t g, size_t stride) {
+
+    unsigned char* buffer = NULL;
+
+    size_t used = (s->columns + GRID_WORD - 1) / GRID_WORD;
+
+    size_t row = 0;
+    size_t word = 0;
+
+    uint64_t w = 0;
+
+    /* First column of the word */
+    size_t column = 0;
+
+    if ((buffer = (unsigned char*) malloc(stride * sizeof(uint64_t) + 1)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    for (row = 0; row < s->rows; row++) {
+
+        if (fread(buffer, sizeof(uint64_t), stride, file) != stride) {
+
+            free(buffer);
+
+            return EXIT_FAILURE;
+        }
+
+        for (word = 0; (row < g->rows) && (word < used); word++) {
+
+            column = word * GRID_WORD;
+
+            if (column >= g->columns) {
+                break ;
+            }
+
+            w = Snapshot_get(buffer + word * sizeof(uint64_t), sizeof(uint64_t));
+
+            /* Drop the columns the grid does not have */
+            if (g->columns - column < GRID_WORD) {
+                w &= (UINT64_C(1) << (g->columns - column)) - 1;
+            }
+
+            if (g->format == GRID_BITS) {
+
+                Grid_row(g, row)[word] = w;
+
+                continue ;
+            }
+
+            for (; w; w &= w - 1) {
+                Grid_set(g, row, column + __builtin_ctzll(w), 1);
+            }
+        }
+    }
+
+    free(buffer);
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Check whether a grid holds cells in a state other than dead and alive.
+*/
+static int _Snapshot_has_states(const Grid_t g) {
+
+    size_t row = 0;
+    size_t column = 0;
+
+    const unsigned char* cells = NULL;
+
+    if (g->format != GRID_BYTES) {
+        return 0;
+    }
+
+    for (row = 0; row < g->rows; row++) {
+
+        for (cells = Grid_bytes(g, row), column = 0; column < g->columns; column++) {
+
+            if (cells[column] > 1) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* ================================ */
+
+/**
+ * Read rows of a byte per cell.
+*/
+static int _Snapshot_read_states(FILE* file, const Snapshot* s, Grid_t g) {
+
+    unsigned char* buffer = NULL;
+
+    size_t row = 0;
+    size_t column = 0;
+
+    /* Columns of the file the grid has */
+    size_t columns = (s->columns < g->columns) ? s->columns : g->columns;
+
+    if ((buffer = (unsigned char*) malloc(s->columns)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    for (row = 0; row < s->rows; row++) {
+
+        if (fread(buffer, 1, s->columns, file) != s->columns) {
+
+            free(buffer);
+
+            return EXIT_FAILURE;
+        }
+
+        if (row >= g->rows) {
+            continue ;
+        }
+
+        if (g->format == GRID_BYTES) {
+
+            memcpy(Grid_bytes(g, row), buffer, columns);
+
+            continue ;
+        }
+
+        for (column = 0; column < columns; column++) {
+            Grid_set(g, row, column, buffer[column] == 1);
+        }
+    }
+
+    free(buffer);
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Write a `SNAPSHOT_LINES` snapshot through a shared mapping of the file.
+*/
+static int _Snapshot_save_lines(const char* filename, const Snapshot* s, const Grid_t g) {
+
+    unsigned char* map = NULL;
+
+    size_t stride = LINES(g->columns);
+    size_t used = (g->columns + GRID_WORD - 1) / GRID_WORD;
+    size_t size = SNAPSHOT_PAGE + g->rows * stride * sizeof(uint64_t);
+
+    size_t row = 0;
+    size_t word = 0;
+
+    int fd = -1;
+    int status = EXIT_SUCCESS;
+
+    if ((fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0) {
+        return EXIT_FAILURE;
+    }
+
+    if ((ftruncate(fd, (off_t) size) != 0) || ((map = (unsigned char*) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)) {
+
+        close(fd);
+
+        return EXIT_FAILURE;
+    }
+
+    _Snapshot_write_header(map, s, SNAPSHOT_LINES, g);
+
+    /* A bit-packed grid already has the layout of the payload */
+    if (NATIVE && (g->format == GRID_BITS)) {
+        memcpy(map + SNAPSHOT_PAGE, g->cells, g->rows * stride * sizeof(uint64_t));
+    }
+    else {
+
+        for (row = 0; row < g->rows; row++) {
+
+            for (word = 0; word < used; word++) {
+                Snapshot_put(map + SNAPSHOT_PAGE + (row * stride + word) * sizeof(uint64_t), Grid_word(g, row, word), sizeof(uint64_t));
+            }
+        }
+    }
+
+    if ((msync(map, size, MS_SYNC) != 0) || (fsync(fd) != 0)) {
+        status = EXIT_FAILURE;
+    }
+
+    munmap(map, size);
+
+    if (close(fd) != 0) {
+        status = EXIT_FAILURE;
+    }
+
+    return status;
+}
+
+/* ================================ */
+
+/**
+ * Write `g` into the snapshot file `filename` and flush it to the disk.
+*/
+static int _Snapshot_write(const char* filename, const Snapshot* s, const Grid_t g) {
+
+    FILE* file = NULL;
+
+    unsigned char header[SNAPSHOT_HEADER] = {0};
+
+    /* A single row of the payload */
+    unsigned char* buffer = NULL;
+
+    size_t used = (g->columns + GRID_WORD - 1) / GRID_WORD;
+    size_t population = 0;
+
+    size_t row = 0;
+    size_t word = 0;
+
+    uint32_t encoding = SNAPSHOT_BITS;
+
+    int status = EXIT_SUCCESS;
+
+    /* Words only hold whether cells are alive */
+    if (_Snapshot_has_states(g)) {
+        encoding = SNAPSHOT_STATES;
+    }
+    else if (s->encoding == SNAPSHOT_LINES) {
+        return _Snapshot_save_lines(filename, s, g);
+    }
+
+    for (row = 0; row < g->rows; row++) {
+
+        for (word = 0; word < used; word++) {
+            population += __builtin_popcountll(Grid_word(g, row, word));
+        }
+    }
+
+    /* A run costs a byte or two; a word 64 cells. Sparse worlds are smaller as runs */
+    if ((encoding == SNAPSHOT_BITS) && (population * 32 < g->rows * g->columns)) {
+        encoding = SNAPSHOT_RLE;
+    }
+
+    if ((buffer = (unsigned char*) malloc(used * sizeof(uint64_t) + 1)) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    if ((file = file_create(filename)) == NULL) {
+
+        free(buffer);
+
+        return EXIT_FAILURE;
+    }
+
+    setvbuf(file, NULL, _IOFBF, BUFFER);
+
+    _Snapshot_write_header(header, s, encoding, g);
+
+    fwrite(header, 1, SNAPSHOT_HEADER, file);
+
+    if (encoding == SNAPSHOT_RLE) {
+        _Snapshot_write_rle(file, g);
+    }
+    else if (encoding == SNAPSHOT_STATES) {
+
+        for (row = 0; row < g->rows; row++) {
+            fwrite(Grid_bytes(g, row), 1, g->columns, file);
+        }
+    }
+    else {
+
+        for (row = 0; row < g->rows; row++) {
+
+            for (word = 0; word < used; word++) {
+                Snapshot_put(buffer + word * sizeof(uint64_t), Grid_word(g, row, word), sizeof(uint64_t));
+            }
+
+            fwrite(buffer, sizeof(uint64_t), used, file);
+        }
+    }
+
+    if (ferror(file) || (fflush(file) != 0) || (fsync(fileno(file)) != 0)) {
+        status = EXIT_FAILURE;
+    }
+
+    if (fclose(file) != 0) {
+        status = EXIT_FAILURE;
+    }
+
+    free(buffer);
+
+    return status;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+void Snapshot_put(unsigned char* p, uint64_t v, size_t size) {
+
+    size_t i = 0;
+
+    for (i = 0; i < size; i++) {
+        p[i] = (unsigned char) (v >> (8 * i));
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+
+uint64_t Snapshot_get(const unsigned char* p, size_t size) {
+
+    uint64_t v = 0;
+
+    size_t i = 0;
+
+    for (i = 0; i < size; i++) {
+        v |= (uint64_t) p[i] << (8 * i);
+    }
+
+    return v;
+}
+
+/* ================================================================ */
+
+int Snapshot_save(const char* filename, const Snapshot* s, const Grid_t g) {
+
+    char temp[SNAPSHOT_PATH + sizeof(SNAPSHOT_TEMP)];
+
+    if ((filename == NULL) || (s == NULL) || (g == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    if (snprintf(temp, sizeof(temp), "%s" SNAPSHOT_TEMP, filename) >= (int) sizeof(temp)) {
+        return EXIT_FAILURE;
+    }
+
+    /* The old file stays until the new one is complete. Renamed over, it lives on for as long as a grid maps it:
+     * truncating it instead would turn the pages of that grid not touched yet into zeros */
+    if ((_Snapshot_write(temp, s, g) == EXIT_FAILURE) || (rename(temp, filename) != 0)) {
+
+        remove(temp);
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+int Snapshot_load(const char* filename, Snapshot* s, Grid_t g) {
+
+    FILE* file = NULL;
+
+    unsigned char header[SNAPSHOT_HEADER];
+
+    int status = EXIT_SUCCESS;
+
+    if ((filename == NULL) || (s == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    if ((file = fopen(filename, "rb")) == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    setvbuf(file, NULL, _IOFBF, BUFFER);
+
+    if ((fread(header, 1, SNAPSHOT_HEADER, file) != SNAPSHOT_HEADER) || (_Snapshot_read_header(header, s) == EXIT_FAILURE)) {
+
+        fclose(file);
+
+        return EXIT_FAILURE;
+    }
+
+    if ((g != NULL) && (s->rows > 0) && (s->columns > 0)) {
+
+        Grid_clear(g, 0);
+
+        if (s->encoding == SNAPSHOT_RLE) {
+            status = _Snapshot_read_rle(file, s, g);
+        }
+        else if (s->encoding == SNAPSHOT_STATES) {
+            status = _Snapshot_read_states(file, s, g);
+        }
+        else if (s->encoding == SNAPSHOT_LINES) {
+            status = (fseek(file, SNAPSHOT_PAGE, SEEK_SET) == 0) ? _Snapshot_read_bits(file, s, g, LINES(s->columns)) : EXIT_FAILURE;
+        }
+        else {
+            status = _Snapshot_read_bits(file, s, g, (s->columns + GRID_WORD - 1) / GRID_WORD);
+        }
+    }
+
+    fclose(file);
+
+    return status;
+}
+
+/* ================================================================ */
+
+Grid_t Snapshot_map(const char* filename, Snapshot* s) {
+
+    Grid_t g = NULL;
+
+    unsigned char header[SNAPSHOT_HEADER];
+
+    struct stat st;
+
+    void* map = NULL;
+
+    size_t size = 0;
+
+    int fd = -1;
+
+    if ((filename == NULL) || (s == NULL) || !NATIVE) {
+        return NULL;
+    }
+
+    if ((fd = open(filename, O_RDONLY)) < 0) {
+        return NULL;
+    }
+
+    if ((read(fd, header, SNAPSHOT_HEADER) != SNAPSHOT_HEADER) || (_Snapshot_read_header(header, s) == EXIT_FAILURE) || (s->encoding != SNAPSHOT_LINES) || (fstat(fd, &st) != 0)) {
+
+        close(fd);
+
+        return NULL;
+    }
+
+    size = SNAPSHOT_PAGE + s->rows * LINES(s->columns) * sizeof(uint64_t);
+
+    /* A private writable mapping: written pages become copies, the file stays as it is */
+    if (((size_t) st.st_size < size) || ((map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)) == MAP_FAILED)) {
+
+        close(fd);
+
+        return NULL;
+    }
+
+    /* The mapping outlives the descriptor */
+    close(fd);
+
+    if ((g = (Grid_t) calloc(1, sizeof(struct grid))) == NULL) {
+
+        munmap(map, size);
+
+        return NULL;
+    }
+
+    g->rows = s->rows;
+    g->columns = s->columns;
+    g->format = GRID_BITS;
+    g->words = LINES(s->columns);
+    g->cells = (uint64_t*) ((unsigned char*) map + SNAPSHOT_PAGE);
+    g->mapping = map;
+    g->mapped = size;
+
+    return g;
+}
+
+/* ================================================================ */
+
+#undef BUFFER
+#undef NATIVE
+#undef LINES
@@ -0,0 +1,95 @@
+#ifndef GOL_SNAPSHOT_H
+#define GOL_SNAPSHOT_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define SNAPSHOT_MAGIC "GOLS"   /* First bytes of every snapshot file */
+#define SNAPSHOT_VERSION 3
+
+#define SNAPSHOT_HEADER 72      /* Size of the header in the file */
+#define SNAPSHOT_RULE 32        /* Size of the rule field, including the terminating 0 */
+
+#define SNAPSHOT_BITS 0         /* Payload: every row as little-endian 64-bit words, bit `c % 64` of word `c / 64` being column `c` */
+#define SNAPSHOT_RLE 1          /* Payload: lengths of alternating runs of dead and live cells, in row-major order, as LEB128 varints. The first run is dead */
+#define SNAPSHOT_LINES 2        /* Payload: as `SNAPSHOT_BITS`, but starting at `SNAPSHOT_PAGE` with every row padded to whole 64-byte lines,
+                                 * which is how a bit-packed grid lays out its cells. Since version 2 */
+#define SNAPSHOT_STATES 3       /* Payload: every row as `columns` bytes, the state of every cell. Written for cells decaying through more than two states. Since version 3 */
+
+#define SNAPSHOT_PATH 256       /* Maximum path size */
+#define SNAPSHOT_TEMP ".tmp"    /* Suffix of a file being written. It replaces the saved one once synced */
+
+#define SNAPSHOT_PAGE 4096      /* Offset of a `SNAPSHOT_LINES` payload. Page aligned, so the payload can be mapped as the cells of a grid */
+
+/* ================================================================ */
+
+/**
+ * Header of a snapshot. In the file, every field is little-endian, in the order
+ * magic (4 bytes), version (4), encoding (4), type (4), rows (8), columns (8), generation (8), rule (32).
+*/
+struct snapshot {
+
+    uint32_t version;
+
+    uint32_t encoding;          /* `SNAPSHOT_BITS`, `SNAPSHOT_RLE`, `SNAPSHOT_LINES` or `SNAPSHOT_STATES` */
+
+    uint32_t type;              /* Edge type of the world */
+
+    uint64_t rows;
+    uint64_t columns;
+
+    uint64_t generation;
+
+    char rule[SNAPSHOT_RULE];   /* Rule of the world, such as "B3/S23" */
+};
+
+typedef struct snapshot Snapshot;
+
+/* ================================================================ */
+
+/**
+ * Store the `size` low bytes of `v` at `p`, little-endian.
+*/
+extern void Snapshot_put(unsigned char* p, uint64_t v, size_t size);
+
+/* ================================================================ */
+
+/**
+ * Read a `size`-byte little-endian number at `p`.
+*/
+extern uint64_t Snapshot_get(const unsigned char* p, size_t size);
+
+/* ================================================================ */
+
+/**
+ * Write `g` into a snapshot file in a single pass. The size of `g` is written into the header.
+ * A byte grid holding decaying states is written as `SNAPSHOT_STATES`. Otherwise, if `s->encoding` is `SNAPSHOT_LINES`,
+ * the file is written through a shared mapping and synced with `msync`; if not, the encoding is picked from the density of the cells.
+ * The file is written under `filename` + `SNAPSHOT_TEMP`, synced and renamed over `filename`: a failed save leaves the old file,
+ * and a grid mapped from it by `Snapshot_map` can be saved back to it.
+*/
+extern int Snapshot_save(const char* filename, const Snapshot* s, const Grid_t g);
+
+/* ================================================================ */
+
+/**
+ * Read the header of a snapshot file into `s` and its cells into `g` in a single pass. A file may describe a world
+ * of a different size than `g`: cells outside of `g` are dropped, cells missing from the file are dead.
+ * A bit-packed grid only keeps the live cells of a `SNAPSHOT_STATES` file.
+ * If `g` is NULL, only the header is read.
+*/
+extern int Snapshot_load(const char* filename, Snapshot* s, Grid_t g);
+
+/* ================================================================ */
+
+/**
+ * Map a `SNAPSHOT_LINES` snapshot file privately and return a bit-packed grid whose cells are the mapped payload.
+ * Pages are only read when first touched, and copied when first written, so the file is never modified.
+ * Returns NULL if the file is not a `SNAPSHOT_LINES` snapshot or cannot be mapped.
+*/
+extern Grid_t Snapshot_map(const char* filename, Snapshot* s);
+
+/* ================================================================ */
+
+#endif /* GOL_SNAPSHOT_H */
@@ -0,0 +1,492 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/* Position of the chunk holding the cell `x`, rounding towards minus infinity */
+#define CHUNK_OF(x) (((x) < 0) ? -((-(x) - 1) / CHUNK) - 1 : (x) / CHUNK)
+
+/* ================================ */
+
+static size_t _Sparse_hash(int32_t row, int32_t column) {
+
+    uint64_t h = (uint64_t) (uint32_t) row * UINT64_C(0x9E3779B97F4A7C15) ^ (uint64_t) (uint32_t) column * UINT64_C(0xC2B2AE3D27D4EB4F);
+
+    return (size_t) (h ^ (h >> 32));
+}
+
+/* ================================ */
+
+static struct chunk* _Sparse_find(const Sparse_t s, int32_t row, int32_t column) {
+
+    struct chunk* c = NULL;
+
+    for (c = s->table[_Sparse_hash(row, column) & (s->buckets - 1)]; c != NULL; c = c->next) {
+
+        if ((c->row == row) && (c->column == column)) {
+            return c;
+        }
+    }
+
+    return NULL;
+}
+
+/* ================================ */
+
+/**
+ * Double the number of buckets. The table is left as it is if there is no memory for it.
+*/
+static void _Sparse_grow(Sparse_t s) {
+
+    struct chunk** table = NULL;
+    struct chunk* c = NULL;
+
+    size_t i = 0;
+    size_t h = 0;
+
+    if ((table = (struct chunk**) calloc(s->buckets * 2, sizeof(struct chunk*))) == NULL) {
+        return ;
+    }
+
+    for (i = 0; i < s->count; i++) {
+
+        c = s->list[i];
+        h = _Sparse_hash(c->row, c->column) & (s->buckets * 2 - 1);
+
+        c->next = table[h];
+        table[h] = c;
+    }
+
+    free(s->table);
+
+    s->table = table;
+    s->buckets *= 2;
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Get the chunk at (`row`, `column`), creating an empty one if there is none.
+*/
+static struct chunk* _Sparse_add(Sparse_t s, int32_t row, int32_t column) {
+
+    struct chunk* c = NULL;
+    struct chunk** list = NULL;
+    struct chunk_block* b = NULL;
+
+    size_t h = 0;
+    size_t i = 0;
+
+    if ((c = _Sparse_find(s, row, column)) != NULL) {
+        return c;
+    }
+
+    if (s->count == s->capacity) {
+
+        if ((list = (struct chunk**) realloc(s->list, (s->capacity * 2) * sizeof(struct chunk*))) == NULL) {
+            return NULL;
+        }
+
+        s->list = list;
+        s->capacity *= 2;
+    }
+
+    if (s->free == NULL) {
+
+        if ((b = (struct chunk_block*) malloc(sizeof(struct chunk_block))) == NULL) {
+            return NULL;
+        }
+
+        b->next = s->blocks;
+        s->blocks = b;
+
+        for (i = 0; i < CHUNK_BLOCK; i++) {
+            b->chunks[i].next = s->free;
+            s->free = &b->chunks[i];
+        }
+
+        s->allocated += CHUNK_BLOCK;
+    }
+
+    c = s->free;
+    s->free = c->next;
+
+    memset(c->cells, 0, sizeof(c->cells));
+
+    h = _Sparse_hash(row, column) & (s->buckets - 1);
+
+    c->row = row;
+    c->column = column;
+    c->index = s->count;
+    c->next = s->table[h];
+
+    s->table[h] = c;
+    s->list[s->count++] = c;
+
+    if (s->count > s->buckets) {
+        _Sparse_grow(s);
+    }
+
+    return c;
+}
+
+/* ================================ */
+
+static void _Sparse_remove(Sparse_t s, struct chunk* c) {
+
+    struct chunk** link = &s->table[_Sparse_hash(c->row, c->column) & (s->buckets - 1)];
+
+    while (*link != c) {
+        link = &(*link)->next;
+    }
+
+    *link = c->next;
+
+    s->list[c->index] = s->list[--s->count];
+    s->list[c->index]->index = c->index;
+
+    c->next = s->free;
+    s->free = c;
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Make sure every chunk next to a live cell on the border of `c` exists, since cells may be born there.
+*/
+static int _Sparse_border(Sparse_t s, const struct chunk* c) {
+
+    const uint64_t* cells = c->cells[s->parity];
+
+    /* Union of the rows: bit 0 tells about the west border, bit 63 about the east one */
+    uint64_t any = 0;
+
+    int32_t row = c->row;
+    int32_t column = c->column;
+
+    size_t r = 0;
+
+    for (r = 0; r < CHUNK; r++) {
+        any |= cells[r];
+    }
+
+    if (((cells[0] != 0) && (_Sparse_add(s, row - 1, column) == NULL))
+        || ((cells[CHUNK - 1] != 0) && (_Sparse_add(s, row + 1, column) == NULL))
+        || ((any & 1) && (_Sparse_add(s, row, column - 1) == NULL))
+        || ((any >> (CHUNK - 1)) && (_Sparse_add(s, row, column + 1) == NULL))
+        || ((cells[0] & 1) && (_Sparse_add(s, row - 1, column - 1) == NULL))
+        || ((cells[0] >> (CHUNK - 1)) && (_Sparse_add(s, row - 1, column + 1) == NULL))
+        || ((cells[CHUNK - 1] & 1) && (_Sparse_add(s, row + 1, column - 1) == NULL))
+        || ((cells[CHUNK - 1] >> (CHUNK - 1)) && (_Sparse_add(s, row + 1, column + 1) == NULL))) {
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Compute the next generation of a chunk from its current one and those of its eight neighbours.
+*/
+static void _Sparse_evolve(const Sparse_t s, struct chunk* c) {
+
+    const int p = s->parity;
+
+    /* Neighbouring chunks, row by row. Missing ones are empty */
+    struct chunk* n[9];
+
+    /* Rows -1 .. CHUNK of the column of chunks, and of the columns to the west and to the east of it */
+    uint64_t mid[CHUNK + 2], west[CHUNK + 2], east[CHUNK + 2];
+
+    /* `mid` shifted so that every bit holds its neighbour to the west (l) and to the east (r) */
+    uint64_t l[CHUNK + 2], r[CHUNK + 2];
+
+    size_t i = 0;
+
+    for (i = 0; i < 9; i++) {
+        n[i] = (i == 4) ? c : _Sparse_find(s, c->row + (int32_t) (i / 3) - 1, c->column + (int32_t) (i % 3) - 1);
+    }
+
+    west[0] = (n[0] != NULL) ? n[0]->cells[p][CHUNK - 1] : 0;
+    mid[0] = (n[1] != NULL) ? n[1]->cells[p][CHUNK - 1] : 0;
+    east[0] = (n[2] != NULL) ? n[2]->cells[p][CHUNK - 1] : 0;
+
+    for (i = 0; i < CHUNK; i++) {
+        west[i + 1] = (n[3] != NULL) ? n[3]->cells[p][i] : 0;
+        mid[i + 1] = c->cells[p][i];
+        east[i + 1] = (n[5] != NULL) ? n[5]->cells[p][i] : 0;
+    }
+
+    west[CHUNK + 1] = (n[6] != NULL) ? n[6]->cells[p][0] : 0;
+    mid[CHUNK + 1] = (n[7] != NULL) ? n[7]->cells[p][0] : 0;
+    east[CHUNK + 1] = (n[8] != NULL) ? n[8]->cells[p][0] : 0;
+
+    for (i = 0; i < CHUNK + 2; i++) {
+        l[i] = (mid[i] << 1) | (west[i] >> (CHUNK - 1));
+        r[i] = (mid[i] >> 1) | (east[i] << (CHUNK - 1));
+    }
+
+    for (i = 1; i <= CHUNK; i++) {
+        c->cells[!p][i - 1] = Kernel_rule(l[i - 1], mid[i - 1], r[i - 1], l[i], mid[i], r[i], l[i + 1], mid[i + 1], r[i + 1], s->born, s->survives);
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+static int _Sparse_is_empty(const uint64_t* cells) {
+
+    size_t i = 0;
+
+    for (i = 0; i < CHUNK; i++) {
+
+        if (cells[i] != 0) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+Sparse_t Sparse_new(const Rule* rule) {
+
+    Sparse_t s = NULL;
+
+    if ((rule == NULL) || !Rule_is_planar(rule)) {
+        return NULL;
+    }
+
+    if ((s = (Sparse_t) calloc(1, sizeof(struct sparse))) == NULL) {
+        return NULL;
+    }
+
+    s->born = rule->born;
+    s->survives = rule->survives;
+
+    s->buckets = 1 << 10;
+    s->capacity = 1 << 10;
+
+    if (((s->table = (struct chunk**) calloc(s->buckets, sizeof(struct chunk*))) == NULL)
+        || ((s->list = (struct chunk**) malloc(s->capacity * sizeof(struct chunk*))) == NULL)) {
+
+        Sparse_destroy(&s);
+
+        return NULL;
+    }
+
+    return s;
+}
+
+/* ================================================================ */
+
+int Sparse_import(Sparse_t s, const Grid_t g) {
+
+    size_t row = 0;
+    size_t column = 0;
+
+    if ((s == NULL) || (g == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    while (s->count > 0) {
+        _Sparse_remove(s, s->list[s->count - 1]);
+    }
+
+    for (row = 0; row < g->rows; row++) {
+
+        for (column = 0; column < g->columns; column++) {
+
+            if (Grid_get(g, row, column) && (Sparse_set(s, row, column, 1) == EXIT_FAILURE)) {
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+void Sparse_export(const Sparse_t s, Grid_t g, int64_t top, int64_t left) {
+
+    const struct chunk* c = NULL;
+
+    /* Position of a chunk row, in cells */
+    int64_t row = 0;
+    int64_t column = 0;
+
+    uint64_t bits = 0;
+
+    size_t i = 0;
+    size_t r = 0;
+
+    if ((s == NULL) || (g == NULL)) {
+        return ;
+    }
+
+    Grid_clear(g, 0);
+
+    for (i = 0; i < s->count; i++) {
+
+        c = s->list[i];
+        column = (int64_t) c->column * CHUNK;
+
+        if ((column + CHUNK <= left) || (column >= left + (int64_t) g->columns)) {
+            continue ;
+        }
+
+        for (r = 0; r < CHUNK; r++) {
+
+            row = (int64_t) c->row * CHUNK + (int64_t) r;
+
+            if ((row < top) || (row >= top + (int64_t) g->rows)) {
+                continue ;
+            }
+
+            for (bits = c->cells[s->parity][r]; bits; bits &= bits - 1) {
+
+                if ((column + __builtin_ctzll(bits) >= left) && (column + __builtin_ctzll(bits) < left + (int64_t) g->columns)) {
+                    Grid_set(g, row - top, column + __builtin_ctzll(bits) - left, 1);
+                }
+            }
+        }
+    }
+
+    return ;
+}
+
+/* ================================================================ */
+
+int Sparse_set(Sparse_t s, int64_t row, int64_t column, int v) {
+
+    struct chunk* c = NULL;
+
+    int64_t r = CHUNK_OF(row);
+    int64_t k = CHUNK_OF(column);
+
+    if ((s == NULL) || (r < INT32_MIN + 1) || (r > INT32_MAX - 1) || (k < INT32_MIN + 1) || (k > INT32_MAX - 1)) {
+        return EXIT_FAILURE;
+    }
+
+    /* Clearing a cell never needs a new chunk. An emptied chunk is freed by the next step */
+    if ((c = (v) ? _Sparse_add(s, r, k) : _Sparse_find(s, r, k)) == NULL) {
+        return (v) ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if (v) {
+        c->cells[s->parity][row - r * CHUNK] |= UINT64_C(1) << (column - k * CHUNK);
+    }
+    else {
+        c->cells[s->parity][row - r * CHUNK] &= ~(UINT64_C(1) << (column - k * CHUNK));
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+int Sparse_step(Sparse_t s) {
+
+    /* Number of chunks before the step */
+    size_t count = 0;
+
+    size_t i = 0;
+
+    if (s == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    count = s->count;
+
+    /* Cells can be born up to one cell away from the live ones */
+    for (i = 0; i < count; i++) {
+
+        if (_Sparse_border(s, s->list[i]) == EXIT_FAILURE) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (i = 0; i < s->count; i++) {
+        _Sparse_evolve(s, s->list[i]);
+    }
+
+    s->parity = !s->parity;
+
+    /* Removing a chunk moves the last one into its place, so walk backwards */
+    for (i = s->count; i > 0; i--) {
+
+        if (_Sparse_is_empty(s->list[i - 1]->cells[s->parity])) {
+            _Sparse_remove(s, s->list[i - 1]);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+void Sparse_log(const Sparse_t s) {
+
+    size_t population = 0;
+
+    size_t i = 0;
+    size_t r = 0;
+
+    if (s == NULL) {
+        return ;
+    }
+
+    for (i = 0; i < s->count; i++) {
+
+        for (r = 0; r < CHUNK; r++) {
+            population += __builtin_popcountll(s->list[i]->cells[s->parity][r]);
+        }
+    }
+
+    printf("%-16s: %ld\n", "population", population);
+    printf("%-16s: %ld (%.1f MiB allocated)\n", "chunks", s->count, s->allocated * sizeof(struct chunk) / 1048576.0);
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Sparse_destroy(Sparse_t* s) {
+
+    struct chunk_block* b = NULL;
+
+    if ((s == NULL) || (*s == NULL)) {
+        return ;
+    }
+
+    while ((b = (*s)->blocks) != NULL) {
+
+        (*s)->blocks = b->next;
+
+        free(b);
+    }
+
+    free((*s)->table);
+    free((*s)->list);
+    free(*s);
+
+    *s = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
+
+#undef CHUNK_OF
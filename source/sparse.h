@@ -0,0 +1,116 @@
+#ifndef GOL_SPARSE_H
+#define GOL_SPARSE_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define CHUNK 64                /* Side of a chunk. A chunk row is a single word */
+#define CHUNK_BLOCK 256         /* Number of chunks allocated at once */
+
+/* ================================================================ */
+
+/**
+ * A square of CHUNK * CHUNK cells of the plane. Bit `c` of `cells[parity][r]` is the cell in row `r` and column `c` of the chunk.
+*/
+struct chunk {
+
+    int32_t row;                /* Position of the chunk, in chunks. Row `row` of chunks starts with the row of cells `row * CHUNK` */
+    int32_t column;
+
+    size_t index;               /* Position in the list of chunks */
+
+    struct chunk* next;         /* Next chunk of the same hash bucket, or of the free list */
+
+    uint64_t cells[2][CHUNK];   /* Current and next generation */
+};
+
+/* ================================ */
+
+struct chunk_block {
+
+    struct chunk_block* next;
+
+    struct chunk chunks[CHUNK_BLOCK];
+};
+
+/* ================================ */
+
+/**
+ * An unbounded plane of cells, holding only the chunks with live cells in them.
+*/
+struct sparse {
+
+    struct chunk** table;       /* Hash table of the chunks, keyed by their position */
+    size_t buckets;             /* Number of buckets. A power of two */
+
+    struct chunk** list;        /* Every chunk, in no particular order */
+    size_t count;               /* Number of chunks */
+    size_t capacity;            /* Size of the list */
+
+    struct chunk_block* blocks; /* Memory of the chunks */
+    struct chunk* free;         /* Chunks of the blocks not in use */
+    size_t allocated;           /* Number of chunks in the blocks */
+
+    int parity;                 /* Index of the current generation in every chunk */
+
+    unsigned born;              /* Masks of the rule of the plane, as in `Rule` */
+    unsigned survives;
+};
+
+typedef struct sparse Sparse;
+
+typedef Sparse* Sparse_t;
+
+/* ================================================================ */
+
+/**
+ * Create an empty plane evolving under `rule`, which must be planar (see `Rule_is_planar`).
+*/
+extern Sparse_t Sparse_new(const Rule* rule);
+
+/* ================================================================ */
+
+/**
+ * Replace the whole plane by the cells of `g`. Cell (`row`, `column`) of `g` becomes cell (`row`, `column`) of the plane.
+*/
+extern int Sparse_import(Sparse_t s, const Grid_t g);
+
+/* ================================================================ */
+
+/**
+ * Copy the part of the plane whose top left cell is (`top`, `left`) and whose size is that of `g` into `g`.
+*/
+extern void Sparse_export(const Sparse_t s, Grid_t g, int64_t top, int64_t left);
+
+/* ================================================================ */
+
+/**
+ * Set the cell at (`row`, `column`) to `v`.
+*/
+extern int Sparse_set(Sparse_t s, int64_t row, int64_t column, int v);
+
+/* ================================================================ */
+
+/**
+ * Advance the plane by a generation. Chunks left without live cells are freed.
+*/
+extern int Sparse_step(Sparse_t s);
+
+/* ================================================================ */
+
+/**
+ * Print the number of chunks and the memory they take.
+*/
+extern void Sparse_log(const Sparse_t s);
+
+/* ================================================================ */
+
+/**
+ * Deallocate the plane and set the pointer to NULL.
+*/
+extern void Sparse_destroy(Sparse_t* s);
+
+/* ================================================================ */
+
+#endif /* GOL_SPARSE_H */
@@ -0,0 +1,128 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+Tiles_t Tiles_new(size_t rows, size_t columns) {
+
+    Tiles_t t = NULL;
+
+    if ((t = (Tiles_t) calloc(1, sizeof(struct tiles))) == NULL) {
+        return NULL;
+    }
+
+    t->cell_rows = rows;
+    t->cell_columns = columns;
+
+    /* An empty world is still a single (empty) tile */
+    t->rows = (rows > 0) ? (rows + TILE_ROWS - 1) / TILE_ROWS : 1;
+    t->columns = (columns > 0) ? (columns + TILE_COLUMNS - 1) / TILE_COLUMNS : 1;
+
+    if (((t->changed = (unsigned char*) calloc(Tiles_count(t), 1)) == NULL)
+        || ((t->changing = (unsigned char*) calloc(Tiles_count(t), 1)) == NULL)) {
+
+        Tiles_destroy(&t);
+
+        return NULL;
+    }
+
+    Tiles_touch_all(t);
+
+    return t;
+}
+
+/* ================================================================ */
+
+int Tiles_dirty(const Tiles_t t, size_t tile) {
+
+    size_t row = tile / t->columns;
+    size_t column = tile % t->columns;
+
+    size_t r, c;
+
+    /* Offsets of -1, 0 and +1 taken modulo the number of tiles */
+    size_t i, j;
+
+    for (i = 0; i < 3; i++) {
+
+        r = (row + t->rows + i - 1) % t->rows;
+
+        for (j = 0; j < 3; j++) {
+
+            c = (column + t->columns + j - 1) % t->columns;
+
+            if (t->changed[r * t->columns + c]) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* ================================================================ */
+
+void Tiles_touch(Tiles_t t, size_t row, size_t column) {
+
+    if (t == NULL) {
+        return ;
+    }
+
+    t->changed[(row / TILE_ROWS) * t->columns + column / TILE_COLUMNS] = 1;
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Tiles_touch_all(Tiles_t t) {
+
+    if (t == NULL) {
+        return ;
+    }
+
+    memset(t->changed, 1, Tiles_count(t));
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Tiles_begin(Tiles_t t) {
+
+    memset(t->changing, 0, Tiles_count(t));
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Tiles_end(Tiles_t t) {
+
+    unsigned char* temp = t->changed;
+
+    t->changed = t->changing;
+    t->changing = temp;
+
+    return ;
+}
+
+/* ================================================================ */
+
+void Tiles_destroy(Tiles_t* t) {
+
+    if ((t == NULL) || (*t == NULL)) {
+        return ;
+    }
+
+    free((*t)->changed);
+    free((*t)->changing);
+    free(*t);
+
+    *t = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
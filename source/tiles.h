@@ -0,0 +1,104 @@
+#ifndef GOL_TILES_H
+#define GOL_TILES_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define TILE_ROWS 64            /* Height of a tile */
+#define TILE_COLUMNS 256        /* Width of a tile. A multiple of 64, so tiles of a bit-packed grid never share a word */
+
+/* ================================================================ */
+
+/**
+ * A world split into tiles, with a flag per tile telling whether any of its cells changed during the last generation.
+*/
+struct tiles {
+
+    size_t rows;                /* Number of tiles vertically */
+    size_t columns;             /* Number of tiles horizontally */
+
+    size_t cell_rows;           /* Number of rows of cells covered */
+    size_t cell_columns;        /* Number of columns of cells covered */
+
+    unsigned char* changed;     /* For every tile, whether it changed during the last generation */
+    unsigned char* changing;    /* For every tile, whether it is changing during the generation being computed */
+};
+
+typedef struct tiles Tiles;
+
+typedef Tiles* Tiles_t;
+
+/* ================================================================ */
+
+/**
+ * Get the number of tiles.
+*/
+#define Tiles_count(t) ((t)->rows * (t)->columns)
+
+/* ================================ */
+
+/**
+ * Get the cells covered by the tile `tile`: the rows `*top` .. `*bottom - 1` and the columns `*left` .. `*right - 1`.
+*/
+#define Tiles_region(t, tile, top, bottom, left, right) \
+    do { \
+        *(top) = ((tile) / (t)->columns) * TILE_ROWS; \
+        *(left) = ((tile) % (t)->columns) * TILE_COLUMNS; \
+        *(bottom) = (*(top) + TILE_ROWS < (t)->cell_rows) ? *(top) + TILE_ROWS : (t)->cell_rows; \
+        *(right) = (*(left) + TILE_COLUMNS < (t)->cell_columns) ? *(left) + TILE_COLUMNS : (t)->cell_columns; \
+    } while (0)
+
+/* ================================================================ */
+
+/**
+ * Split a world of size rows * columns into tiles. Every tile starts out as changed.
+*/
+extern Tiles_t Tiles_new(size_t rows, size_t columns);
+
+/* ================================================================ */
+
+/**
+ * Check whether the tile `tile` or any of its eight neighbours changed during the last generation. Tiles wrap around the edges.
+ * Tiles for which this is false cannot change during the next generation.
+*/
+extern int Tiles_dirty(const Tiles_t t, size_t tile);
+
+/* ================================================================ */
+
+/**
+ * Mark the tile holding the cell at (`row`, `column`) as changed. Call it whenever a cell is modified outside of an evolution step.
+*/
+extern void Tiles_touch(Tiles_t t, size_t row, size_t column);
+
+/* ================================================================ */
+
+/**
+ * Mark every tile as changed.
+*/
+extern void Tiles_touch_all(Tiles_t t);
+
+/* ================================================================ */
+
+/**
+ * Start a new generation: every tile is unchanged until evolved otherwise.
+*/
+extern void Tiles_begin(Tiles_t t);
+
+/* ================================================================ */
+
+/**
+ * Finish a generation: the tiles marked as changing become the changed ones.
+*/
+extern void Tiles_end(Tiles_t t);
+
+/* ================================================================ */
+
+/**
+ * Deallocate the tiles and set the pointer to NULL.
+*/
+extern void Tiles_destroy(Tiles_t* t);
+
+/* ================================================================ */
+
+#endif /* GOL_TILES_H */
@@ -0,0 +1,103 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+Triple_t Triple_new(size_t rows, size_t columns, int format) {
+
+    Triple_t t = NULL;
+
+    size_t i = 0;
+
+    if ((t = (Triple_t) calloc(1, sizeof(struct triple))) == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < 3; i++) {
+
+        if ((t->grids[i] = Grid_new(rows, columns, format)) == NULL) {
+
+            Triple_destroy(&t);
+
+            return NULL;
+        }
+    }
+
+    /* The consumer starts with grid 0, the producer with grid 1, and grid 2 is in the middle */
+    t->front = 0;
+    t->back = 1;
+
+    atomic_init(&t->state, 2);
+
+    return t;
+}
+
+/* ================================================================ */
+
+void Triple_publish(Triple_t t, const Grid_t g, size_t generation) {
+
+    Grid_t back = NULL;
+
+    if ((t == NULL) || (g == NULL)) {
+        return ;
+    }
+
+    back = t->grids[t->back];
+
+    if ((g->rows != back->rows) || (g->columns != back->columns) || (g->format != back->format)) {
+        return ;
+    }
+
+    memcpy(back->cells, g->cells, g->rows * g->words * sizeof(uint64_t));
+
+    t->generations[t->back] = generation;
+
+    /* The filled grid goes into the middle, released to the consumer; whatever was there becomes the next back grid */
+    t->back = atomic_exchange_explicit(&t->state, t->back | TRIPLE_FRESH, memory_order_acq_rel) & ~TRIPLE_FRESH;
+
+    return ;
+}
+
+/* ================================================================ */
+
+Grid_t Triple_acquire(Triple_t t, size_t* generation) {
+
+    if (t == NULL) {
+        return NULL;
+    }
+
+    /* Only a fresh middle grid is worth taking; the one taken back is stale and stays in the middle until the producer replaces it */
+    if (atomic_load_explicit(&t->state, memory_order_relaxed) & TRIPLE_FRESH) {
+        t->front = atomic_exchange_explicit(&t->state, t->front, memory_order_acq_rel) & ~TRIPLE_FRESH;
+    }
+
+    if (generation != NULL) {
+        *generation = t->generations[t->front];
+    }
+
+    return t->grids[t->front];
+}
+
+/* ================================================================ */
+
+void Triple_destroy(Triple_t* t) {
+
+    size_t i = 0;
+
+    if ((t == NULL) || (*t == NULL)) {
+        return ;
+    }
+
+    for (i = 0; i < 3; i++) {
+        Grid_destroy(&(*t)->grids[i]);
+    }
+
+    free(*t);
+
+    *t = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
@@ -0,0 +1,62 @@
+#ifndef GOL_TRIPLE_H
+#define GOL_TRIPLE_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define TRIPLE_FRESH 4          /* Flag of `state`: the middle grid holds a generation the consumer has not taken yet */
+
+/* ================================================================ */
+
+/**
+ * Three grids handing generations over from a single producer to a single consumer without a lock.
+ * The producer fills its back grid and swaps it with the middle one; the consumer swaps its front grid with the middle one when it is fresh.
+ * Neither side ever waits: the producer overwrites a generation not taken yet, the consumer keeps the last one it took.
+*/
+struct triple {
+
+    Grid_t grids[3];
+    size_t generations[3];      /* Generation held by every grid */
+
+    _Atomic unsigned state;     /* Index of the middle grid, plus `TRIPLE_FRESH` */
+
+    unsigned back;              /* Index of the grid being filled. Owned by the producer */
+    unsigned front;             /* Index of the grid being read. Owned by the consumer */
+};
+
+typedef struct triple Triple;
+
+typedef Triple* Triple_t;
+
+/* ================================================================ */
+
+/**
+ * Create a handoff of generations of size rows * columns in the layout `format`.
+*/
+extern Triple_t Triple_new(size_t rows, size_t columns, int format);
+
+/* ================================================================ */
+
+/**
+ * Hand the generation `generation`, held by `g`, over to the consumer. Only called by the producer.
+*/
+extern void Triple_publish(Triple_t t, const Grid_t g, size_t generation);
+
+/* ================================================================ */
+
+/**
+ * Get the latest generation handed over and its number. The grid stays valid until the next call. Only called by the consumer.
+*/
+extern Grid_t Triple_acquire(Triple_t t, size_t* generation);
+
+/* ================================================================ */
+
+/**
+ * Deallocate a handoff and set the pointer to NULL.
+*/
+extern void Triple_destroy(Triple_t* t);
+
+/* ================================================================ */
+
+#endif /* GOL_TRIPLE_H */
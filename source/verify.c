@@ -0,0 +1,724 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/* Kinds of implementation */
+#define KERNEL 1        /* A kernel evolving the whole grid at once */
+#define SCHED 2         /* The tile scheduler, skipping stable tiles */
+#define HASHLIFE 3      /* A HashLife plane, copied into the grid */
+#define SPARSE 4        /* A sparse plane, copied into the grid */
+
+#define CANDIDATES 16   /* Most implementations compared in a scenario */
+
+/* FNV-1a */
+#define FNV_OFFSET UINT64_C(14695981039346656037)
+#define FNV_PRIME UINT64_C(1099511628211)
+
+/* ================================ */
+
+/**
+ * An implementation checked against the reference, with its own grids.
+*/
+struct candidate {
+
+    const char* name;
+
+    int kind;
+    Kernel_t kernel;            /* With `KERNEL` and `SCHED` */
+
+    Grid_t grids[2];            /* `grids[parity]` holds its current generation */
+    int parity;
+
+    Tiles_t tiles;              /* With `SCHED` */
+    Sched_t sched;
+
+    Quad_t quad;                /* With `HASHLIFE`, whose steps advance 2^`step` generations */
+    unsigned step;
+
+    Sparse_t sparse;            /* With `SPARSE` */
+
+    size_t generation;          /* Generation it has reached */
+
+    int done;                   /* Set once it diverged, failed, or left the window it is compared on */
+};
+
+/* ================================ */
+
+/* Oscillators and spaceships, as rows of live (O) and dead (.) cells */
+static const char* BLINKER[] = {"OOO", NULL};
+static const char* TOAD[] = {".OOO", "OOO.", NULL};
+static const char* BEACON[] = {"OO..", "OO..", "..OO", "..OO", NULL};
+static const char* PULSAR[] = {
+    "..OOO...OOO..", ".............", "O....O.O....O", "O....O.O....O", "O....O.O....O", "..OOO...OOO..", ".............",
+    "..OOO...OOO..", "O....O.O....O", "O....O.O....O", "O....O.O....O", ".............", "..OOO...OOO..", NULL
+};
+static const char* PENTADECATHLON[] = {"..O....O..", "OO.OOOO.OO", "..O....O..", NULL};
+static const char* GLIDER[] = {".O.", "..O", "OOO", NULL};
+static const char* LWSS[] = {".O..O", "O....", "O...O", "OOOO.", NULL};
+static const char* MWSS[] = {"...O..", ".O...O", "O.....", "O....O", "OOOOO.", NULL};
+static const char* HWSS[] = {"...OO..", ".O....O", "O......", "O.....O", "OOOOOO.", NULL};
+static const char* R_PENTOMINO[] = {".OO", "OO.", ".O.", NULL};
+static const char* GOSPER_GUN[] = {
+    "........................O...........", "......................O.O...........", "............OO......OO............OO",
+    "...........O...O....OO............OO", "OO........O.....O...OO..............", "OO........O...O.OO....O.O...........",
+    "..........O.....O.......O...........", "...........O...O....................", "............OO......................", NULL
+};
+
+/* Where they go in the grid of the zoo */
+static const struct {
+    const char** cells;
+    size_t top;
+    size_t left;
+} ZOO[] = {
+    {GOSPER_GUN, 10, 10},
+    {PULSAR, 30, 70},
+    {PENTADECATHLON, 55, 100},
+    {BLINKER, 80, 20},
+    {TOAD, 80, 40},
+    {BEACON, 80, 60},
+    {GLIDER, 85, 150},
+    {LWSS, 50, 200},
+    {MWSS, 65, 240},
+    {HWSS, 20, 200},
+    {R_PENTOMINO, 60, 150},
+};
+
+/* Rules of every family, and whether the zoo, whose patterns are those of Life, is run under them */
+static const struct {
+    const char* rule;
+    int zoo;
+} RULES[] = {
+    {"B3/S23", 1},
+    {"B36/S23", 0},
+    {"B3678/S34678", 0},
+    {"B2/S", 0},
+    {"B1357/S1357", 0},
+    {"B0/S8", 0},
+    {"B2/S/C3", 0},
+    {"B2/S345/C4", 0},
+    {"R5,C0,M1,S34..58,B34..45", 0},
+    {"R2,C3,M0,S3..7,B4..6", 0},
+};
+
+static const char* EDGES[] = {"", "torus", "dead", "alive"};
+
+/* ================================ */
+
+/**
+ * Add the live cells of a pattern to `g`, its top left corner at (`top`, `left`).
+*/
+static void _Verify_place(Grid_t g, const char** cells, size_t top, size_t left) {
+
+    size_t row = 0;
+    size_t column = 0;
+
+    for (row = 0; cells[row] != NULL; row++) {
+
+        for (column = 0; cells[row][column] != '\0'; column++) {
+
+            if ((cells[row][column] == 'O') && (top + row < g->rows) && (left + column < g->columns)) {
+                Grid_set(g, top + row, left + column, 1);
+            }
+        }
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Fill the middle half of `g` with a soup of cells in random states, away from the edges so that planes can follow it.
+*/
+static void _Verify_soup(Grid_t g, const Rule* rule) {
+
+    size_t row = 0;
+    size_t column = 0;
+
+    srand(VERIFY_SEED);
+
+    for (row = g->rows / 4; row < 3 * g->rows / 4; row++) {
+
+        for (column = g->columns / 4; column < 3 * g->columns / 4; column++) {
+            Grid_set(g, row, column, (rand() % 2) ? 1 + rand() % (rule->states - 1) : 0);
+        }
+    }
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Hash the states of the cells of `g` in row-major order, whatever its layout, and count its live cells.
+*/
+static uint64_t _Verify_hash(const Grid_t g, size_t* population) {
+
+    uint64_t hash = FNV_OFFSET;
+
+    size_t row = 0;
+    size_t column = 0;
+
+    unsigned char cell = 0;
+
+    *population = 0;
+
+    for (row = 0; row < g->rows; row++) {
+
+        for (column = 0; column < g->columns; column++) {
+
+            cell = Grid_get(g, row, column);
+
+            hash = (hash ^ cell) * FNV_PRIME;
+
+            *population += (cell == 1);
+        }
+    }
+
+    return hash;
+}
+
+/* ================================ */
+
+/**
+ * Check whether a cell of the outermost rows and columns of `g` is not dead.
+*/
+static int _Verify_border(const Grid_t g) {
+
+    size_t row = 0;
+    size_t column = 0;
+
+    for (row = 0; row < g->rows; row++) {
+
+        for (column = 0; column < g->columns; column += ((row == 0) || (row + 1 == g->rows) || (column + 1 == g->columns)) ? 1 : g->columns - 1) {
+
+            if (Grid_get(g, row, column) != 0) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* ================================ */
+
+/**
+ * Set up an implementation on a copy of `start` in the layout `format`. A NULL `kernel` stands for the one `Kernel_select` picks.
+ * A HashLife plane advances 2^`step` generations at a time.
+ * Returns EXIT_FAILURE if it cannot be set up, in which case it is left out.
+*/
+static int _Verify_add(struct candidate* c, const char* name, int kind, int format, Kernel_t kernel, unsigned step, const Rule* rule, const Grid_t start, size_t threads) {
+
+    size_t row = 0;
+    size_t column = 0;
+
+    *c = (struct candidate) {.name = name, .kind = kind, .kernel = kernel, .step = step};
+
+    if (((c->grids[0] = Grid_new(start->rows, start->columns, format)) == NULL) || ((c->grids[1] = Grid_new(start->rows, start->columns, format)) == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    for (row = 0; row < start->rows; row++) {
+
+        for (column = 0; column < start->columns; column++) {
+            Grid_set(c->grids[0], row, column, Grid_get(start, row, column));
+        }
+    }
+
+    if (c->kernel == NULL) {
+        c->kernel = Kernel_select(c->grids[0], rule);
+    }
+
+    if (kind == SCHED) {
+
+        if (((c->tiles = Tiles_new(start->rows, start->columns)) == NULL) || ((c->sched = Sched_new(c->tiles, threads)) == NULL)) {
+            return EXIT_FAILURE;
+        }
+
+        Tiles_touch_all(c->tiles);
+    }
+
+    if ((kind == HASHLIFE) && (((c->quad = Quad_new(0, rule)) == NULL) || (Quad_import(c->quad, c->grids[0]) == EXIT_FAILURE))) {
+        return EXIT_FAILURE;
+    }
+
+    if ((kind == SPARSE) && (((c->sparse = Sparse_new(rule)) == NULL) || (Sparse_import(c->sparse, c->grids[0]) == EXIT_FAILURE))) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+static void _Verify_destroy(struct candidate* c) {
+
+    Grid_destroy(&c->grids[0]);
+    Grid_destroy(&c->grids[1]);
+
+    Sched_destroy(&c->sched);
+    Tiles_destroy(&c->tiles);
+
+    Quad_destroy(&c->quad);
+    Sparse_destroy(&c->sparse);
+
+    return ;
+}
+
+/* ================================ */
+
+/**
+ * Advance an implementation by a step: a generation, or 2^`step` of them for HashLife.
+*/
+static int _Verify_step(struct candidate* c, const Rule* rule, int edge, Pool_t pool) {
+
+    Grid_t current = c->grids[c->parity];
+    Grid_t next = c->grids[!c->parity];
+
+    switch (c->kind) {
+
+        case KERNEL:
+
+            if (Grid_halo(current, edge) == EXIT_FAILURE) {
+                return EXIT_FAILURE;
+            }
+
+            c->kernel(next, current, rule, 0, current->rows, 0, current->columns);
+            c->parity = !c->parity;
+            c->generation++;
+
+            break ;
+
+        case SCHED:
+
+            if (Grid_halo(current, edge) == EXIT_FAILURE) {
+                return EXIT_FAILURE;
+            }
+
+            Sched_run(c->sched, c->tiles, pool, c->kernel, rule, next, current);
+            c->parity = !c->parity;
+            c->generation++;
+
+            break ;
+
+        case HASHLIFE:
+
+            if (Quad_step(c->quad, c->step) == EXIT_FAILURE) {
+                return EXIT_FAILURE;
+            }
+
+            Quad_export(c->quad, current);
+            c->generation += (size_t) 1 << c->step;
+
+            break ;
+
+        case SPARSE:
+
+            if (Sparse_step(c->sparse) == EXIT_FAILURE) {
+                return EXIT_FAILURE;
+            }
+
+            Sparse_export(c->sparse, current, 0, 0);
+            c->generation++;
+
+            break ;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================ */
+
+/**
+ * Set up every implementation able to evolve `rule` in the edge mode `edge`. Returns their number.
+ * Every implementation that cannot be set up is reported and counted in `broken`: it would otherwise go untested.
+*/
+static size_t _Verify_candidates(struct candidate* c, const Rule* rule, int edge, const Grid_t start, size_t threads, size_t* broken) {
+
+    size_t n = 0;
+
+    /* Bit-packed grids only hold two states */
+    const int bits = (rule->states == 2);
+
+    #define ADD(label, kind, format, kernel, step) \
+        do { \
+            if (_Verify_add(&c[n], label, kind, format, kernel, step, rule, start, threads) == EXIT_SUCCESS) { \
+                n++; \
+            } \
+            else { \
+                printf("FAIL %s %s %s: cannot set up\n", rule->name, EDGES[edge], label); \
+                _Verify_destroy(&c[n]); \
+                (*broken)++; \
+            } \
+        } while (0)
+
+    if (rule->range > 1) {
+
+        if (bits) {
+            ADD("larger/bits", KERNEL, GRID_BITS, Kernel_larger, 0);
+        }
+
+        ADD("larger/bytes", KERNEL, GRID_BYTES, Kernel_larger, 0);
+    }
+    else if (rule->states > 2) {
+        ADD("generations", KERNEL, GRID_BYTES, Kernel_generations, 0);
+    }
+    else {
+
+        ADD("bits", KERNEL, GRID_BITS, Kernel_bits, 0);
+        ADD("bits/select", KERNEL, GRID_BITS, NULL, 0);
+
+        ADD("bytes", KERNEL, GRID_BYTES, Kernel_bytes, 0);
+
+#ifdef SIMD_X86
+
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("sse2")) {
+            ADD("sse2", KERNEL, GRID_BYTES, Kernel_sse2, 0);
+        }
+
+        if (__builtin_cpu_supports("avx2")) {
+            ADD("avx2", KERNEL, GRID_BYTES, Kernel_avx2, 0);
+        }
+
+        if (__builtin_cpu_supports("avx512bw")) {
+            ADD("avx512", KERNEL, GRID_BYTES, Kernel_avx512, 0);
+        }
+
+#endif
+    }
+
+    if (bits) {
+        ADD("sched/bits", SCHED, GRID_BITS, NULL, 0);
+    }
+
+    ADD("sched/bytes", SCHED, GRID_BYTES, NULL, 0);
+
+    /* Planes are unbounded: they match a world with dead edges */
+    if (Rule_is_planar(rule) && (edge == GRID_DEAD)) {
+
+        ADD("hashlife", HASHLIFE, GRID_BITS, NULL, 0);
+
+        ADD("hashlife/8", HASHLIFE, GRID_BITS, NULL, 3);
+
+        ADD("sparse", SPARSE, GRID_BITS, NULL, 0);
+    }
+
+    #undef ADD
+
+    return n;
+}
+
+/* ================================ */
+
+/**
+ * Save a soup as a `SNAPSHOT_LINES` snapshot, map it back as a world with `"map": 1` does, save the mapped grid
+ * over the very file it is mapped from, and load that file again. Returns the number of mismatches.
+*/
+static size_t _Verify_snapshot(void) {
+
+    char path[] = "/tmp/gol-verify-XXXXXX";
+
+    Snapshot s = {.encoding = SNAPSHOT_LINES, .type = GRID_DEAD, .rule = "B3/S23"};
+
+    Rule rule;
+
+    Grid_t start = NULL;
+    Grid_t mapped = NULL;
+    Grid_t loaded = NULL;
+
+    uint64_t hash = 0;
+    size_t population = 0;
+    size_t p = 0;
+
+    size_t failures = 0;
+
+    int fd = -1;
+
+    if ((fd = mkstemp(path)) < 0) {
+
+        printf("FAIL snapshot: cannot create %s\n", path);
+
+        return 1;
+    }
+
+    close(fd);
+
+    Rule_parse(&rule, s.rule);
+
+    if (((start = Grid_new(VERIFY_ROWS, VERIFY_COLUMNS, GRID_BITS)) == NULL) || ((loaded = Grid_new(VERIFY_ROWS, VERIFY_COLUMNS, GRID_BITS)) == NULL)) {
+
+        printf("FAIL snapshot: cannot allocate the grids\n");
+
+        failures++;
+    }
+    else {
+
+        _Verify_soup(start, &rule);
+
+        hash = _Verify_hash(start, &population);
+
+        /* The mapped grid is not touched before it is saved: its pages still have to be read from the file */
+        if ((Snapshot_save(path, &s, start) == EXIT_FAILURE) || ((mapped = Snapshot_map(path, &s)) == NULL)
+            || (Snapshot_save(path, &s, mapped) == EXIT_FAILURE) || (Snapshot_load(path, &s, loaded) == EXIT_FAILURE)) {
+
+            printf("FAIL snapshot: cannot save, map, save and load %s\n", path);
+
+            failures++;
+        }
+        else if (_Verify_hash(mapped, &p) != hash) {
+
+            printf("FAIL snapshot: %zu live cells saved, %zu left in the grid mapped from them after saving it back\n", population, p);
+
+            failures++;
+        }
+        else if (_Verify_hash(loaded, &p) != hash) {
+
+            printf("FAIL snapshot: %zu live cells saved over the file they are mapped from, %zu loaded\n", population, p);
+
+            failures++;
+        }
+        else {
+            printf("%-26s %-5s %-5s: %zu live cells mapped, saved back and loaded\n", "snapshot", "soup", "map", population);
+        }
+    }
+
+    Grid_destroy(&mapped);
+    Grid_destroy(&loaded);
+    Grid_destroy(&start);
+
+    remove(path);
+
+    return failures;
+}
+
+/* ================================ */
+
+/**
+ * Run a scenario: evolve `start` under `rule` in the edge mode `edge` with the reference and every other implementation,
+ * comparing them after every generation. Returns the number of implementations that diverged.
+*/
+static size_t _Verify_scenario(const Rule* rule, const char* pattern, int edge, const Grid_t start, size_t generations, Pool_t pool) {
+
+    struct candidate c[CANDIDATES];
+
+    /* The reference */
+    Grid_t grids[2] = {NULL, NULL};
+    int parity = 0;
+
+    size_t generation = 0;
+
+    size_t count = 0;
+    size_t failures = 0;
+
+    /* Implementations that could not be set up */
+    size_t broken = 0;
+
+    /* Generation after which the planes stopped being compared, or 0 */
+    size_t left = 0;
+
+    uint64_t hash = 0;
+    size_t population = 0;
+
+    uint64_t h = 0;
+    size_t p = 0;
+
+    size_t row = 0;
+    size_t column = 0;
+
+    size_t i = 0;
+
+    int active = 0;
+
+    if (((grids[0] = Grid_new(start->rows, start->columns, GRID_BYTES)) == NULL) || ((grids[1] = Grid_new(start->rows, start->columns, GRID_BYTES)) == NULL)) {
+
+        Grid_destroy(&grids[0]);
+
+        printf("FAIL %s %s %s: cannot allocate the reference\n", rule->name, pattern, EDGES[edge]);
+
+        return 1;
+    }
+
+    for (row = 0; row < start->rows; row++) {
+
+        for (column = 0; column < start->columns; column++) {
+            Grid_set(grids[0], row, column, Grid_get(start, row, column));
+        }
+    }
+
+    count = _Verify_candidates(c, rule, edge, start, (pool != NULL) ? pool->size : 1, &broken);
+
+    for (generation = 0, active = 1; (generation < generations) && active; ) {
+
+        /* A plane only matches a world with dead edges until its cells reach the border: then they would leave the world */
+        if ((left == 0) && _Verify_border(grids[parity])) {
+
+            for (i = 0; i < count; i++) {
+
+                if (((c[i].kind == HASHLIFE) || (c[i].kind == SPARSE)) && !c[i].done) {
+
+                    c[i].done = 1;
+
+                    left = generation;
+                }
+            }
+        }
+
+        if (Grid_halo(grids[parity], edge) == EXIT_FAILURE) {
+            break ;
+        }
+
+        Kernel_scalar(grids[!parity], grids[parity], rule, 0, start->rows, 0, start->columns);
+
+        parity = !parity;
+        generation++;
+
+        hash = _Verify_hash(grids[parity], &population);
+
+        for (i = 0, active = 0; i < count; i++) {
+
+            while (!c[i].done && (c[i].generation < generation)) {
+
+                if (_Verify_step(&c[i], rule, edge, pool) == EXIT_FAILURE) {
+
+                    printf("FAIL %s %s %s %s: cannot evolve generation %zu\n", rule->name, pattern, EDGES[edge], c[i].name, c[i].generation + 1);
+
+                    c[i].done = 1;
+
+                    failures++;
+                }
+            }
+
+            if (!c[i].done && (c[i].generation == generation)) {
+
+                h = _Verify_hash(c[i].grids[c[i].parity], &p);
+
+                if ((h != hash) || (p != population)) {
+
+                    /* Find the first cell that differs, the layouts of both grids being possibly different */
+                    for (row = 0, column = 0; (row < start->rows) && (Grid_get(grids[parity], row, column) == Grid_get(c[i].grids[c[i].parity], row, column)); ) {
+
+                        if (++column == start->columns) {
+                            column = 0;
+                            row++;
+                        }
+                    }
+
+                    printf("FAIL %s %s %s %s: generation %zu differs at cell (%zu, %zu): %u expected, %u found (population %zu, %zu)\n",
+                        rule->name, pattern, EDGES[edge], c[i].name, generation, row, column,
+                        (row < start->rows) ? Grid_get(grids[parity], row, column) : 0, (row < start->rows) ? Grid_get(c[i].grids[c[i].parity], row, column) : 0,
+                        population, p);
+
+                    c[i].done = 1;
+
+                    failures++;
+                }
+            }
+
+            active |= !c[i].done;
+        }
+    }
+
+    printf("%-26s %-5s %-5s: %zu generations, %zu of %zu implementations agree", rule->name, pattern, EDGES[edge], generation, count - failures, count + broken);
+
+    if (left > 0) {
+        printf(", planes followed %zu generations", left);
+    }
+
+    printf("\n");
+
+    for (i = 0; i < count; i++) {
+        _Verify_destroy(&c[i]);
+    }
+
+    Grid_destroy(&grids[0]);
+    Grid_destroy(&grids[1]);
+
+    return failures + broken;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+int Verify_run(size_t generations, size_t threads) {
+
+    Rule rule;
+
+    Grid_t start = NULL;
+
+    Pool_t pool = NULL;
+
+    size_t failures = 0;
+
+    size_t r = 0;
+    size_t i = 0;
+
+    int edge = 0;
+
+    if ((threads != 1) && ((pool = Pool_new(threads)) == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    if ((start = Grid_new(VERIFY_ROWS, VERIFY_COLUMNS, GRID_BYTES)) == NULL) {
+
+        Pool_destroy(&pool);
+
+        return EXIT_FAILURE;
+    }
+
+    failures += _Verify_snapshot();
+
+    for (r = 0; r < sizeof(RULES) / sizeof(RULES[0]); r++) {
+
+        if (Rule_parse(&rule, RULES[r].rule) == EXIT_FAILURE) {
+
+            printf("FAIL %s: not a rule\n", RULES[r].rule);
+
+            failures++;
+
+            continue ;
+        }
+
+        for (edge = GRID_TORUS; edge <= GRID_ALIVE; edge++) {
+
+            Grid_clear(start, 0);
+            _Verify_soup(start, &rule);
+
+            failures += _Verify_scenario(&rule, "soup", edge, start, (rule.range > 1) ? (generations + 9) / 10 : generations, pool);
+
+            if (!RULES[r].zoo) {
+                continue ;
+            }
+
+            Grid_clear(start, 0);
+
+            for (i = 0; i < sizeof(ZOO) / sizeof(ZOO[0]); i++) {
+                _Verify_place(start, ZOO[i].cells, ZOO[i].top, ZOO[i].left);
+            }
+
+            failures += _Verify_scenario(&rule, "zoo", edge, start, generations, pool);
+        }
+    }
+
+    printf("%s: %zu mismatches\n", (failures > 0) ? "FAIL" : "OK", failures);
+
+    Grid_destroy(&start);
+    Pool_destroy(&pool);
+
+    return (failures > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+#undef KERNEL
+#undef SCHED
+#undef HASHLIFE
+#undef SPARSE
+#undef CANDIDATES
+#undef FNV_OFFSET
+#undef FNV_PRIME
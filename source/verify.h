@@ -0,0 +1,31 @@
+#ifndef GOL_VERIFY_H
+#define GOL_VERIFY_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define VERIFY_GENERATIONS 2000 /* Default number of generations of every scenario */
+
+#define VERIFY_ROWS 100         /* Size of the grids. Two tiles in both directions, the last ones partial, and a row of a width that is not a multiple of 64 */
+#define VERIFY_COLUMNS 300
+
+#define VERIFY_SEED 1           /* Seed of the soups */
+
+/* ================================================================ */
+
+/**
+ * Evolve soups, oscillators and spaceships under the reference kernel, `Kernel_scalar`, and under every other implementation
+ * built into the program: the other kernels of both layouts, the tile scheduler, HashLife and the sparse plane.
+ * Every rule family is run in every edge mode, and the population and a hash of the cells of every implementation are compared
+ * with those of the reference after every generation. Planes follow a world with dead edges for as long as its cells stay off the border.
+ * Larger than Life rules, whose reference is far slower, run a tenth of `generations`.
+ * A soup is also mapped from a snapshot, saved back over the file it is mapped from and loaded again.
+ * Prints a line per scenario and, for every implementation that diverges, the first generation and cell that differ.
+ * `threads` is the number of threads of the scheduler, 0 for one per online CPU. Returns EXIT_FAILURE on any mismatch.
+*/
+extern int Verify_run(size_t generations, size_t threads);
+
+/* ================================================================ */
+
+#endif /* GOL_VERIFY_H */
@@ -0,0 +1,265 @@
+#include "include.h"
+
+/* ================================================================ */
+/* ============================ STATIC ============================ */
+/* ================================================================ */
+
+/**
+ * Write the cells of the rows `top` .. `bottom - 1` into the texture, which only holds them once all of them are written.
+*/
+static int _View_upload(View_t v, size_t top, size_t bottom) {
+
+    SDL_Rect rect = {.x = 0, .y = (int) top, .w = (int) v->columns, .h = (int) (bottom - top)};
+
+    void* pixels = NULL;
+    int pitch = 0;
+
+    Uint32* line = NULL;
+    const uint64_t* words = NULL;
+    const unsigned char* levels = NULL;
+
+    uint64_t w = 0;
+
+    size_t row = 0;
+    size_t word = 0;
+    size_t bit = 0;
+    size_t count = 0;
+
+    if (SDL_LockTexture(v->texture, &rect, &pixels, &pitch) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    /* A locked area is write-only and undefined until written, so every row of it is */
+    for (row = top; row < bottom; row++) {
+
+        line = (Uint32*) ((unsigned char*) pixels + (row - top) * (size_t) pitch);
+        words = v->shown + row * v->words;
+
+        if (v->states > 2) {
+
+            levels = v->levels + row * v->columns;
+
+            for (bit = 0; bit < v->columns; bit++) {
+                line[bit] = v->pixels[levels[bit]];
+            }
+
+            v->dirty[row] = 0;
+
+            continue ;
+        }
+
+        for (word = 0; word < v->words; word++, line += GRID_WORD) {
+
+            w = words[word];
+            count = (v->columns - word * GRID_WORD < GRID_WORD) ? v->columns - word * GRID_WORD : GRID_WORD;
+
+            for (bit = 0; bit < count; bit++) {
+                line[bit] = v->pixels[(w >> bit) & 1];
+            }
+        }
+
+        v->dirty[row] = 0;
+    }
+
+    SDL_UnlockTexture(v->texture);
+
+    v->locks++;
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+/* ============================ EXTERN ============================ */
+/* ================================================================ */
+
+View_t View_new(SDL_Renderer* r, size_t rows, size_t columns) {
+
+    View_t v = NULL;
+
+    if ((r == NULL) || (rows == 0) || (columns == 0) || (rows > INT32_MAX) || (columns > INT32_MAX)) {
+        return NULL;
+    }
+
+    if ((v = (View_t) calloc(1, sizeof(struct view))) == NULL) {
+        return NULL;
+    }
+
+    v->rows = rows;
+    v->columns = columns;
+    v->words = (columns + GRID_WORD - 1) / GRID_WORD;
+
+    v->states = 2;
+    v->stale = 1;
+
+    if (((v->shown = (uint64_t*) calloc(rows * v->words, sizeof(uint64_t))) == NULL)
+        || ((v->dirty = (unsigned char*) calloc(rows, 1)) == NULL)
+        || ((v->texture = SDL_CreateTexture(r, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, (int) columns, (int) rows)) == NULL)) {
+
+        View_destroy(&v);
+
+        return NULL;
+    }
+
+    SDL_SetTextureBlendMode(v->texture, SDL_BLENDMODE_BLEND);
+
+    return v;
+}
+
+/* ================================================================ */
+
+int View_update(View_t v, const Grid_t g, const unsigned char (*colors)[4], unsigned states) {
+
+    Uint32 pixel = 0;
+
+    uint64_t* shown = NULL;
+    uint64_t w = 0;
+
+    /* First row of the rows being gathered into a single upload, and one past the last dirty one */
+    size_t first = 0;
+    size_t last = 0;
+
+    int gathering = 0;
+
+    size_t row = 0;
+    size_t word = 0;
+
+    unsigned s = 0;
+
+    if ((v == NULL) || (g == NULL) || (g->rows != v->rows) || (g->columns != v->columns) || (states < 2) || (states > RULE_STATES)) {
+        return EXIT_FAILURE;
+    }
+
+    /* A bit-packed grid holds no decaying states */
+    states = (g->format == GRID_BYTES) ? states : 2;
+
+    if ((states > 2) && (v->levels == NULL)) {
+
+        if ((v->levels = (unsigned char*) calloc(v->rows, v->columns)) == NULL) {
+            return EXIT_FAILURE;
+        }
+
+        v->stale = 1;
+    }
+
+    if (states != v->states) {
+
+        v->states = states;
+        v->stale = 1;
+    }
+
+    for (s = 1; s < ((states > 2) ? RULE_STATES : 2); s++) {
+
+        pixel = ((Uint32) colors[s][3] << 24) | ((Uint32) colors[s][0] << 16) | ((Uint32) colors[s][1] << 8) | (Uint32) colors[s][2];
+
+        if (pixel != v->pixels[s]) {
+
+            v->pixels[s] = pixel;
+            v->stale = 1;
+        }
+    }
+
+    /* Rows are compared word by word against what the texture holds, or byte by byte with decaying states */
+    for (row = 0; (states > 2) && (row < v->rows); row++) {
+
+        if (memcmp(v->levels + row * v->columns, Grid_bytes(g, row), v->columns) != 0) {
+
+            memcpy(v->levels + row * v->columns, Grid_bytes(g, row), v->columns);
+
+            v->dirty[row] = 1;
+        }
+
+        v->dirty[row] |= v->stale;
+    }
+
+    for (row = 0; (states == 2) && (row < v->rows); row++) {
+
+        shown = v->shown + row * v->words;
+
+        for (word = 0; word < v->words; word++) {
+
+            if ((w = Grid_word(g, row, word)) != shown[word]) {
+
+                shown[word] = w;
+
+                v->dirty[row] = 1;
+            }
+        }
+
+        v->dirty[row] |= v->stale;
+    }
+
+    v->stale = 0;
+
+    /* Dirty rows close to each other are uploaded together, so scattered changes do not take a lock each */
+    for (row = 0; row < v->rows; row++) {
+
+        if (!v->dirty[row]) {
+            continue ;
+        }
+
+        if (gathering && (row - last > VIEW_GAP)) {
+
+            if (_View_upload(v, first, last) == EXIT_FAILURE) {
+                return EXIT_FAILURE;
+            }
+
+            gathering = 0;
+        }
+
+        if (!gathering) {
+
+            first = row;
+            gathering = 1;
+        }
+
+        last = row + 1;
+    }
+
+    if (gathering && (_View_upload(v, first, last) == EXIT_FAILURE)) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* ================================================================ */
+
+void View_draw(const View_t v, SDL_Renderer* r, size_t cell_size) {
+
+    SDL_Rect target = {.x = 0, .y = 0};
+
+    if ((v == NULL) || (r == NULL)) {
+        return ;
+    }
+
+    target.w = (int) (v->columns * cell_size);
+    target.h = (int) (v->rows * cell_size);
+
+    SDL_RenderCopy(r, v->texture, NULL, &target);
+
+    return ;
+}
+
+/* ================================================================ */
+
+void View_destroy(View_t* v) {
+
+    if ((v == NULL) || (*v == NULL)) {
+        return ;
+    }
+
+    if ((*v)->texture != NULL) {
+        SDL_DestroyTexture((*v)->texture);
+    }
+
+    free((*v)->shown);
+    free((*v)->levels);
+    free((*v)->dirty);
+    free(*v);
+
+    *v = NULL;
+
+    return ;
+}
+
+/* ================================================================ */
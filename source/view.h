@@ -0,0 +1,72 @@
+#ifndef GOL_VIEW_H
+#define GOL_VIEW_H
+
+#include "include.h"
+
+/* ================================================================ */
+
+#define VIEW_GAP 8              /* Clean rows between two dirty ones below which both are uploaded in a single lock */
+
+/* ================================================================ */
+
+/**
+ * A streaming texture holding a pixel per cell, drawn scaled by the cell size in a single call.
+ * Only rows whose cells changed since the last upload are written into the texture.
+*/
+struct view {
+
+    SDL_Texture* texture;
+
+    size_t rows;
+    size_t columns;
+    size_t words;               /* Number of words of a bit-packed row */
+
+    uint64_t* shown;            /* Cells currently in the texture, as bit-packed rows */
+    unsigned char* levels;      /* With more than two states, the states currently in the texture, a byte per cell. Allocated when first needed */
+    unsigned char* dirty;       /* For every row, whether it differs from the texture */
+
+    Uint32 pixels[RULE_STATES]; /* Pixel of every state. A dead cell is transparent, so whatever was drawn before shows through */
+    unsigned states;            /* Number of states the texture shows */
+
+    int stale;                  /* Set when every row has to be written, as the texture holds nothing yet or the colors changed */
+
+    size_t locks;               /* Number of times the texture was locked */
+};
+
+typedef struct view View;
+
+typedef View* View_t;
+
+/* ================================================================ */
+
+/**
+ * Create a view of a world of size rows * columns for the renderer `r`.
+ * Returns NULL if the texture cannot be created, for instance if it is larger than the renderer allows.
+*/
+extern View_t View_new(SDL_Renderer* r, size_t rows, size_t columns);
+
+/* ================================================================ */
+
+/**
+ * Bring the texture up to date with the cells of `g` evolving under a rule of `states` states, cells in the state `s` in the color `colors[s]` (RGBA).
+ * `colors` holds `RULE_STATES` colors. With two states, or a bit-packed grid, only whether cells are alive is shown.
+*/
+extern int View_update(View_t v, const Grid_t g, const unsigned char (*colors)[4], unsigned states);
+
+/* ================================================================ */
+
+/**
+ * Draw the texture onto the renderer `r`, every cell as a square of `cell_size` pixels.
+*/
+extern void View_draw(const View_t v, SDL_Renderer* r, size_t cell_size);
+
+/* ================================================================ */
+
+/**
+ * Deallocate a view and set the pointer to NULL. Must be called before its renderer is destroyed.
+*/
+extern void View_destroy(View_t* v);
+
+/* ================================================================ */
+
+#endif /* GOL_VIEW_H */
@@ -0,0 +1,44 @@
+#include "source/include.h"
+
+/* ================================================================ */
+
+/**
+ * Golden-output check of the engines, without the game: runs `Verify_run` and exits with its status,
+ * so `make test` fails on any mismatch. Takes the `--generations` and `--threads` of the game.
+*/
+int main(int argc, char** argv) {
+
+    size_t generations = VERIFY_GENERATIONS;
+    size_t threads = 0;
+
+    int option = 0;
+
+    static struct option long_options[] = {
+        {"generations", required_argument, NULL, 0},
+        {"threads", required_argument, NULL, 1},
+        {NULL, 0, NULL, 0},
+    };
+
+    while ((option = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+
+        switch (option) {
+
+            case 0:
+                generations = strtoull(optarg, NULL, 10);
+
+                break ;
+
+            case 1:
+                threads = strtoull(optarg, NULL, 10);
+
+                break ;
+
+            default:
+                fprintf(stderr, "usage: %s [--generations N] [--threads N]\n", argv[0]);
+
+                return EXIT_FAILURE;
+        }
+    }
+
+    return Verify_run((generations > 0) ? generations : VERIFY_GENERATIONS, threads);
+}